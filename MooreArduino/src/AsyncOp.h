@@ -2,6 +2,7 @@
 #define REDUX_ASYNC_OP_H
 
 #include <Arduino.h>
+#include "Clock.h"
 
 namespace MooreArduino {
 
@@ -23,25 +24,45 @@ namespace MooreArduino {
  *     // Handle timeout
  *     wifiConnection.finish();
  *   }
+ * 
+ * Every time-dependent method also takes an explicit `now` so a loop can
+ * share one Clock snapshot between all of its components.
+ * 
+ * The TimeSource parameter selects where "now" comes from (see Clock.h);
+ * `AsyncOp` is the millis()-backed default. `LongAsyncOp` runs on the
+ * 64-bit Millis64TimeSource for timeouts beyond the 49.7 day millis() wrap.
  */
-class AsyncOp {
+template<typename TimeSource = MillisTimeSource>
+class BasicAsyncOp {
+public:
+  typedef typename TimeSource::time_type time_type;
+
+  static const uint32_t PROGRESS_ONE = 1UL << 16;  // getProgressFixed() at 100%
+
 private:
   bool active;
-  unsigned long startTime;
-  unsigned long timeout;
+  time_type startTime;
+  time_type timeout;
 
 public:
   /**
    * Create an inactive async operation
    */
-  AsyncOp() : active(false), startTime(0), timeout(0) {}
+  BasicAsyncOp() : active(false), startTime(0), timeout(0) {}
 
   /**
    * Start the operation with a timeout in milliseconds
    */
-  void start(unsigned long timeoutMs) {
+  void start(time_type timeoutMs) {
+    start(timeoutMs, TimeSource::now());
+  }
+
+  /**
+   * Start the operation at the given timestamp
+   */
+  void start(time_type timeoutMs, time_type now) {
     active = true;
-    startTime = millis();
+    startTime = now;
     timeout = timeoutMs;
   }
 
@@ -56,7 +77,14 @@ public:
    * Check if the operation has timed out
    */
   bool timedOut() const {
-    return active && (millis() - startTime > timeout);
+    return timedOut(TimeSource::now());
+  }
+
+  /**
+   * Check if the operation has timed out at the given timestamp
+   */
+  bool timedOut(time_type now) const {
+    return active && (now - startTime > timeout);
   }
 
   /**
@@ -69,27 +97,49 @@ public:
   /**
    * Get remaining time before timeout (0 if timed out or inactive)
    */
-  unsigned long remainingTime() const {
+  time_type remainingTime() const {
+    return remainingTime(TimeSource::now());
+  }
+
+  /**
+   * Get remaining time at the given timestamp
+   */
+  time_type remainingTime(time_type now) const {
     if (!active) return 0;
     
-    unsigned long elapsed = millis() - startTime;
+    time_type elapsed = now - startTime;
     if (elapsed >= timeout) return 0;
     
     return timeout - elapsed;
   }
 
+  /**
+   * Time until timedOut() turns true (for TicklessIdle::until)
+   * Returns the largest time_type value when the operation is inactive
+   */
+  time_type timeUntilDeadline(time_type now) const {
+    return active ? remainingTime(now) + 1 : ~(time_type)0;  // timedOut() is strictly after the timeout
+  }
+
   /**
    * Get elapsed time since start (0 if inactive)
    */
-  unsigned long elapsedTime() const {
+  time_type elapsedTime() const {
+    return elapsedTime(TimeSource::now());
+  }
+
+  /**
+   * Get elapsed time at the given timestamp
+   */
+  time_type elapsedTime(time_type now) const {
     if (!active) return 0;
-    return millis() - startTime;
+    return now - startTime;
   }
 
   /**
    * Get the timeout duration
    */
-  unsigned long getTimeout() const {
+  time_type getTimeout() const {
     return timeout;
   }
 
@@ -98,15 +148,50 @@ public:
    * Returns 100 if timed out, 0 if inactive
    */
   int getProgress() const {
+    return getProgress(TimeSource::now());
+  }
+
+  /**
+   * Check progress at the given timestamp
+   */
+  int getProgress(time_type now) const {
+    return (int)((getProgressFixed(now) * 100) >> 16);
+  }
+
+  /**
+   * Check progress as a 16.16 fixed-point fraction (0 to PROGRESS_ONE)
+   * Returns PROGRESS_ONE if timed out, 0 if inactive
+   */
+  uint32_t getProgressFixed() const {
+    return getProgressFixed(TimeSource::now());
+  }
+
+  /**
+   * Check fixed-point progress at the given timestamp
+   * Exact to ~1/32768 for any timeout, without overflow or 64-bit division
+   */
+  uint32_t getProgressFixed(time_type now) const {
     if (!active) return 0;
-    
-    unsigned long elapsed = millis() - startTime;
-    if (elapsed >= timeout) return 100;
-    
-    return (elapsed * 100) / timeout;
+
+    time_type elapsed = now - startTime;
+    if (elapsed >= timeout) return PROGRESS_ONE;
+
+    // Scale both down until the timeout fits in 16 bits, so elapsed << 16
+    // fits in 32 bits (elapsed < timeout keeps it below the timeout)
+    time_type t = timeout;
+    time_type e = elapsed;
+    while (t > 0xFFFF) {
+      t >>= 1;
+      e >>= 1;
+    }
+    uint32_t fraction = ((uint32_t)e << 16) / (uint32_t)t;
+    return fraction < PROGRESS_ONE ? fraction : PROGRESS_ONE - 1;  // Not timed out yet
   }
 };
 
+typedef BasicAsyncOp<> AsyncOp;
+typedef BasicAsyncOp<Millis64TimeSource> LongAsyncOp;
+
 } // namespace MooreArduino
 
 #endif // REDUX_ASYNC_OP_H
\ No newline at end of file
@@ -0,0 +1,289 @@
+#ifndef MOORE_ASYNC_OP_POOL_H
+#define MOORE_ASYNC_OP_POOL_H
+
+#include <Arduino.h>
+#include "Clock.h"
+#include "Handle.h"
+
+namespace MooreArduino {
+
+/**
+ * Fixed-capacity pool of concurrent async operations
+ *
+ * Tracks many in-flight operations (scan, connect, DHCP wait, probe...)
+ * at once. Operations are kept in a binary min-heap ordered by deadline,
+ * so pollExpired() only looks at the earliest one: checking for timeouts
+ * is O(1) when nothing expired and O(log n) per expired operation, no
+ * matter how many are in flight.
+ *
+ * Each operation carries a Payload (usually the machine's Input) that is
+ * returned when it times out. Handles carry a generation counter, so
+ * finishing an operation that already timed out is harmless.
+ *
+ * Usage:
+ *   AsyncOpPool<Input, 8> ops;
+ *
+ *   Handle scan = ops.start(15000, Input::scanTimedOut(), now);
+ *   Handle dhcp = ops.start(10000, Input::dhcpTimedOut(), now);
+ *
+ *   // Operation completed normally
+ *   ops.finish(scan);
+ *
+ *   // Every loop: turn timeouts into inputs
+ *   Input timeout;
+ *   while (ops.pollExpired(now, timeout)) {
+ *     machine.step(stamp(timeout, now), now);
+ *   }
+ */
+template<typename Payload, uint16_t Capacity, typename TimeSource = MillisTimeSource>
+class AsyncOpPool {
+public:
+  typedef typename TimeSource::time_type time_type;
+
+private:
+  static const uint16_t NIL = 0xFFFF;
+
+  struct Op {
+    time_type startTime;
+    time_type timeout;
+    Payload payload;
+    uint16_t generation;
+    uint16_t heapPos;   // Position in heap[], NIL when inactive
+    uint16_t nextFree;
+  };
+
+  Op ops[Capacity];
+  uint16_t heap[Capacity];  // Op indices ordered by deadline
+  uint16_t heapSize;
+  uint16_t freeHead;
+
+public:
+  /**
+   * Create an empty pool
+   */
+  AsyncOpPool() {
+    clear();
+  }
+
+  /**
+   * Drop all operations
+   */
+  void clear() {
+    for (uint16_t i = 0; i < Capacity; i++) {
+      ops[i].generation = 1;
+      ops[i].heapPos = NIL;
+      ops[i].nextFree = (i + 1 < Capacity) ? i + 1 : NIL;
+    }
+    heapSize = 0;
+    freeHead = Capacity > 0 ? 0 : NIL;
+  }
+
+  /**
+   * Start an operation with a timeout in milliseconds
+   * @param onTimeout Payload returned by pollExpired() if it times out
+   * @return Handle for finish(), or an invalid Handle if the pool is full
+   */
+  Handle start(time_type timeoutMs, const Payload& onTimeout, time_type now) {
+    if (freeHead == NIL) {
+      return Handle();
+    }
+    uint16_t index = freeHead;
+    Op& op = ops[index];
+    freeHead = op.nextFree;
+
+    op.startTime = now;
+    op.timeout = timeoutMs;
+    op.payload = onTimeout;
+    op.heapPos = heapSize;
+    heap[heapSize++] = index;
+    siftUp(op.heapPos);
+    return Handle(index, op.generation);
+  }
+
+  /**
+   * Start an operation at the current time
+   */
+  Handle start(time_type timeoutMs, const Payload& onTimeout) {
+    return start(timeoutMs, onTimeout, TimeSource::now());
+  }
+
+  /**
+   * Mark an operation as finished (success or failure)
+   * Returns false if the handle is stale
+   */
+  bool finish(const Handle& handle) {
+    if (!isActive(handle)) {
+      return false;
+    }
+    removeAt(ops[handle.index].heapPos);
+    return true;
+  }
+
+  /**
+   * Check if an operation is still in flight
+   */
+  bool isActive(const Handle& handle) const {
+    return handle.index < Capacity &&
+           ops[handle.index].generation == handle.generation &&
+           ops[handle.index].heapPos != NIL;
+  }
+
+  /**
+   * Pop the earliest timed-out operation's payload
+   * Returns false when no operation has timed out
+   */
+  bool pollExpired(time_type now, Payload& out) {
+    if (heapSize == 0) {
+      return false;
+    }
+    const Op& earliest = ops[heap[0]];
+    if (!(now - earliest.startTime > earliest.timeout)) {
+      return false;
+    }
+    out = earliest.payload;
+    removeAt(0);
+    return true;
+  }
+
+  /**
+   * Pop a timed-out operation using the current time
+   */
+  bool pollExpired(Payload& out) {
+    return pollExpired(TimeSource::now(), out);
+  }
+
+  /**
+   * Get the earliest timeout deadline (first instant timedOut would be true)
+   * Returns false if no operation is in flight
+   */
+  bool nextDeadline(time_type& deadline) const {
+    if (heapSize == 0) {
+      return false;
+    }
+    deadline = deadlineOf(heap[0]) + 1;
+    return true;
+  }
+
+  /**
+   * Time until the earliest operation times out (for TicklessIdle::until)
+   * Returns the largest time_type value when no operation is in flight
+   */
+  time_type timeUntilDeadline(time_type now) const {
+    time_type deadline;
+    if (!nextDeadline(deadline)) return ~(time_type)0;
+    time_type delta = deadline - now;
+    return delta > HALF_RANGE ? 0 : delta;  // Already past the deadline
+  }
+
+  /**
+   * Get elapsed time of an operation (0 if not active)
+   */
+  time_type elapsedTime(const Handle& handle, time_type now) const {
+    if (!isActive(handle)) return 0;
+    return now - ops[handle.index].startTime;
+  }
+
+  /**
+   * Get remaining time before an operation times out (0 if timed out or not active)
+   */
+  time_type remainingTime(const Handle& handle, time_type now) const {
+    if (!isActive(handle)) return 0;
+    const Op& op = ops[handle.index];
+    time_type elapsed = now - op.startTime;
+    if (elapsed >= op.timeout) return 0;
+    return op.timeout - elapsed;
+  }
+
+  /**
+   * Number of operations in flight
+   */
+  uint16_t size() const {
+    return heapSize;
+  }
+
+  /**
+   * Check if no operations are in flight
+   */
+  bool isEmpty() const {
+    return heapSize == 0;
+  }
+
+  /**
+   * Maximum number of concurrent operations
+   */
+  uint16_t getCapacity() const {
+    return Capacity;
+  }
+
+private:
+  // Differences above this are negative in two's complement
+  static const time_type HALF_RANGE = ~(time_type)0 >> 1;
+
+  time_type deadlineOf(uint16_t index) const {
+    return ops[index].startTime + ops[index].timeout;
+  }
+
+  /**
+   * Wrap-safe deadline ordering (for any width of time_type)
+   */
+  bool earlier(uint16_t a, uint16_t b) const {
+    return deadlineOf(a) - deadlineOf(b) > HALF_RANGE;
+  }
+
+  void place(uint16_t pos, uint16_t index) {
+    heap[pos] = index;
+    ops[index].heapPos = pos;
+  }
+
+  void siftUp(uint16_t pos) {
+    uint16_t index = heap[pos];
+    while (pos > 0) {
+      uint16_t parent = (pos - 1) / 2;
+      if (!earlier(index, heap[parent])) break;
+      place(pos, heap[parent]);
+      pos = parent;
+    }
+    place(pos, index);
+  }
+
+  void siftDown(uint16_t pos) {
+    uint16_t index = heap[pos];
+    while (true) {
+      uint16_t child = 2 * pos + 1;
+      if (child >= heapSize) break;
+      if (child + 1 < heapSize && earlier(heap[child + 1], heap[child])) {
+        child++;
+      }
+      if (!earlier(heap[child], index)) break;
+      place(pos, heap[child]);
+      pos = child;
+    }
+    place(pos, index);
+  }
+
+  /**
+   * Remove the heap entry at pos and recycle its operation slot
+   */
+  void removeAt(uint16_t pos) {
+    uint16_t index = heap[pos];
+    heapSize--;
+    if (pos < heapSize) {
+      // Fill the hole with the last entry, which may belong above or below it
+      uint16_t moved = heap[heapSize];
+      place(pos, moved);
+      siftDown(pos);
+      siftUp(ops[moved].heapPos);
+    }
+
+    Op& op = ops[index];
+    op.heapPos = NIL;
+    op.generation++;
+    if (op.generation == 0) op.generation = 1;
+    op.nextFree = freeHead;
+    freeHead = index;
+  }
+};
+
+} // namespace MooreArduino
+
+#endif // MOORE_ASYNC_OP_POOL_H
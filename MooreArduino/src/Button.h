@@ -2,6 +2,7 @@
 #define REDUX_BUTTON_H
 
 #include <Arduino.h>
+#include "Clock.h"
 
 namespace MooreArduino {
 
@@ -17,14 +18,21 @@ namespace MooreArduino {
  *     // Button was just pressed
  *     store.dispatch(Action::powerToggle());
  *   }
+ * 
+ * The TimeSource parameter selects where "now" comes from (see Clock.h);
+ * `Button` is the millis()-backed default.
  */
-class Button {
+template<typename TimeSource = MillisTimeSource>
+class BasicButton {
+public:
+  typedef typename TimeSource::time_type time_type;
+
 private:
   int pin;
   bool lastState;
   bool currentState;
-  unsigned long lastChangeTime;
-  unsigned long debounceDelay;
+  time_type lastChangeTime;
+  time_type debounceDelay;
 
 public:
   static const unsigned long DEFAULT_DEBOUNCE_DELAY = 50; // ms
@@ -33,7 +41,7 @@ public:
    * Create a button on the specified pin
    * Sets up INPUT_PULLUP mode automatically
    */
-  Button(int pinNumber, unsigned long debounceMs = DEFAULT_DEBOUNCE_DELAY) 
+  BasicButton(int pinNumber, time_type debounceMs = DEFAULT_DEBOUNCE_DELAY) 
     : pin(pinNumber), lastState(HIGH), currentState(HIGH), 
       lastChangeTime(0), debounceDelay(debounceMs) {
     pinMode(pin, INPUT_PULLUP);
@@ -44,7 +52,14 @@ public:
    * Call this once per loop iteration
    */
   bool wasPressed() {
-    return update() && isPressed();
+    return wasPressed(TimeSource::now());
+  }
+
+  /**
+   * Same as wasPressed() using a shared timestamp (see Clock)
+   */
+  bool wasPressed(time_type now) {
+    return update(now) && isPressed();
   }
 
   /**
@@ -59,15 +74,23 @@ public:
    * Returns true if state changed
    */
   bool update() {
+    return update(TimeSource::now());
+  }
+
+  /**
+   * Update the button state using a shared timestamp (see Clock)
+   * Returns true if state changed
+   */
+  bool update(time_type now) {
     bool reading = digitalRead(pin);
     
     // If state changed, reset debounce timer
     if (reading != lastState) {
-      lastChangeTime = millis();
+      lastChangeTime = now;
     }
     
     // If enough time has passed, accept the new state
-    if (millis() - lastChangeTime > debounceDelay) {
+    if (now - lastChangeTime > debounceDelay) {
       if (reading != currentState) {
         currentState = reading;
         lastState = reading;
@@ -82,14 +105,14 @@ public:
   /**
    * Set debounce delay in milliseconds
    */
-  void setDebounceDelay(unsigned long ms) {
+  void setDebounceDelay(time_type ms) {
     debounceDelay = ms;
   }
 
   /**
    * Get current debounce delay
    */
-  unsigned long getDebounceDelay() const {
+  time_type getDebounceDelay() const {
     return debounceDelay;
   }
 
@@ -101,6 +124,8 @@ public:
   }
 };
 
+typedef BasicButton<> Button;
+
 } // namespace MooreArduino
 
 #endif // REDUX_BUTTON_H
\ No newline at end of file
@@ -0,0 +1,227 @@
+#ifndef MOORE_BUTTON_BANK_H
+#define MOORE_BUTTON_BANK_H
+
+#include <Arduino.h>
+#include "Clock.h"
+
+namespace MooreArduino {
+
+/**
+ * Bank of up to 32 debounced buttons scanned together
+ *
+ * Instead of one digitalRead and two clock reads per Button, the bank
+ * samples every pin at a fixed interval and debounces all of them at once
+ * with bit-sliced vertical counters: each button owns one bit in two
+ * 32-bit counter words, so a handful of bitwise operations debounces the
+ * whole panel. A button changes state after 4 consecutive samples that
+ * agree, i.e. a debounce time of 4 × sampleIntervalMs.
+ *
+ * On AVR the pins are read straight from their port input registers,
+ * one register read per port; elsewhere digitalRead() is used per pin.
+ *
+ * Buttons are active-low (INPUT_PULLUP); bit i in every mask refers to
+ * pins[i].
+ *
+ * Usage:
+ *   const uint8_t panelPins[] = {2, 3, 4, 5, 6, 7};
+ *   ButtonBank panel(panelPins, 6);
+ *
+ *   void loop() {
+ *     if (panel.update(now)) {
+ *       uint32_t pressed = panel.takePressed();
+ *       if (pressed & (1UL << 0)) { // Button on pin 2 was pressed
+ *         machine.step(stamp(Input::powerToggle(), now), now);
+ *       }
+ *     }
+ *   }
+ */
+template<typename TimeSource = MillisTimeSource>
+class BasicButtonBank {
+public:
+  static const uint8_t MAX_BUTTONS = 32;
+  static const unsigned long DEFAULT_SAMPLE_INTERVAL = 10; // ms (40 ms debounce)
+
+private:
+  uint8_t pins[MAX_BUTTONS];
+  uint8_t count;
+  unsigned long sampleInterval;
+  unsigned long lastSample;
+
+  // Vertical counter: bit i of (count1, count0) is button i's 2-bit counter
+  uint32_t count0;
+  uint32_t count1;
+  uint32_t debounced;     // 1 = pressed
+  uint32_t pressedEdges;  // Accumulated until takePressed()
+  uint32_t releasedEdges; // Accumulated until takeReleased()
+
+#if defined(__AVR__)
+  static const uint8_t MAX_PORTS = 12;  // Enough for every port on a Mega
+  volatile uint8_t* ports[MAX_PORTS];
+  uint8_t portCount;
+  uint8_t portIndex[MAX_BUTTONS];
+  uint8_t bitMask[MAX_BUTTONS];
+#endif
+
+public:
+  /**
+   * Create a bank for the given pins (INPUT_PULLUP is set up automatically)
+   * Pins beyond MAX_BUTTONS are ignored
+   */
+  BasicButtonBank(const uint8_t* pinNumbers, uint8_t pinCount,
+                  unsigned long sampleIntervalMs = DEFAULT_SAMPLE_INTERVAL)
+    : count(pinCount > MAX_BUTTONS ? MAX_BUTTONS : pinCount),
+      sampleInterval(sampleIntervalMs), lastSample(0),
+      count0(0), count1(0), debounced(0), pressedEdges(0), releasedEdges(0) {
+#if defined(__AVR__)
+    portCount = 0;
+#endif
+    for (uint8_t i = 0; i < count; i++) {
+      pins[i] = pinNumbers[i];
+      pinMode(pins[i], INPUT_PULLUP);
+#if defined(__AVR__)
+      mapToPort(i);
+#endif
+    }
+  }
+
+  /**
+   * Sample and debounce all buttons if the sample interval has elapsed
+   * Returns true if any button changed state
+   */
+  bool update(unsigned long now) {
+    if (now - lastSample < sampleInterval) {
+      return false;
+    }
+    lastSample = now;
+
+    uint32_t sample = readPins();
+
+    // 2-bit vertical counter per bit: counts consecutive samples that
+    // differ from the debounced state, toggling it on the 4th
+    uint32_t delta = sample ^ debounced;
+    count1 = (count1 ^ count0) & delta;
+    count0 = ~count0 & delta;
+    uint32_t toggle = delta & ~(count0 | count1);
+
+    debounced ^= toggle;
+    pressedEdges |= toggle & debounced;
+    releasedEdges |= toggle & ~debounced;
+    return toggle != 0;
+  }
+
+  /**
+   * Update using the current time
+   */
+  bool update() {
+    return update(TimeSource::now());
+  }
+
+  /**
+   * Get and clear the mask of buttons pressed since the last call
+   */
+  uint32_t takePressed() {
+    uint32_t edges = pressedEdges;
+    pressedEdges = 0;
+    return edges;
+  }
+
+  /**
+   * Get and clear the mask of buttons released since the last call
+   */
+  uint32_t takeReleased() {
+    uint32_t edges = releasedEdges;
+    releasedEdges = 0;
+    return edges;
+  }
+
+  /**
+   * Get the debounced state of all buttons (1 = pressed)
+   */
+  uint32_t getState() const {
+    return debounced;
+  }
+
+  /**
+   * Check if button i is currently pressed (after debouncing)
+   */
+  bool isPressed(uint8_t index) const {
+    return index < count && (debounced & (1UL << index));
+  }
+
+  /**
+   * Get the number of buttons in the bank
+   */
+  uint8_t getCount() const {
+    return count;
+  }
+
+  /**
+   * Get the pin number of button i
+   */
+  int getPin(uint8_t index) const {
+    return index < count ? pins[index] : -1;
+  }
+
+  /**
+   * Set the sampling interval (debounce time is 4 samples)
+   */
+  void setSampleInterval(unsigned long ms) {
+    sampleInterval = ms;
+  }
+
+  /**
+   * Get the sampling interval
+   */
+  unsigned long getSampleInterval() const {
+    return sampleInterval;
+  }
+
+private:
+  /**
+   * Read every pin into a mask (1 = pressed, i.e. pin LOW)
+   */
+  uint32_t readPins() const {
+    uint32_t sample = 0;
+#if defined(__AVR__)
+    // One register read per port, then pick the bits apart
+    uint8_t values[MAX_PORTS];
+    for (uint8_t p = 0; p < portCount; p++) {
+      values[p] = *ports[p];
+    }
+    for (uint8_t i = 0; i < count; i++) {
+      if (!(values[portIndex[i]] & bitMask[i])) {
+        sample |= (1UL << i);
+      }
+    }
+#else
+    for (uint8_t i = 0; i < count; i++) {
+      if (digitalRead(pins[i]) == LOW) {
+        sample |= (1UL << i);
+      }
+    }
+#endif
+    return sample;
+  }
+
+#if defined(__AVR__)
+  /**
+   * Record which port register and bit serve button i
+   */
+  void mapToPort(uint8_t i) {
+    volatile uint8_t* reg = portInputRegister(digitalPinToPort(pins[i]));
+    uint8_t p = 0;
+    while (p < portCount && ports[p] != reg) p++;
+    if (p == portCount && portCount < MAX_PORTS) {
+      ports[portCount++] = reg;
+    }
+    portIndex[i] = (p < portCount) ? p : 0;
+    bitMask[i] = digitalPinToBitMask(pins[i]);
+  }
+#endif
+};
+
+typedef BasicButtonBank<> ButtonBank;
+
+} // namespace MooreArduino
+
+#endif // MOORE_BUTTON_BANK_H
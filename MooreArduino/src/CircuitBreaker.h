@@ -0,0 +1,183 @@
+#ifndef MOORE_CIRCUIT_BREAKER_H
+#define MOORE_CIRCUIT_BREAKER_H
+
+#include <Arduino.h>
+#include "Clock.h"
+
+namespace MooreArduino {
+
+/**
+ * Circuit breaker states
+ */
+enum CircuitState {
+  CIRCUIT_CLOSED,     // Normal operation, attempts allowed
+  CIRCUIT_OPEN,       // Too many failures, attempts blocked while cooling down
+  CIRCUIT_HALF_OPEN   // Cool-down over, the next attempt decides open or closed
+};
+
+/**
+ * Circuit breaker for an operation that keeps failing
+ *
+ * Counts consecutive failures. After `threshold` of them the circuit
+ * opens and allowRequest() refuses attempts for the cool-down period, so
+ * a device on a site whose network is down for hours stops burning radio
+ * time and power on scans that cannot succeed. After the cool-down the
+ * circuit is half-open: one trial attempt is allowed, and its outcome
+ * either closes the circuit or opens it for another cool-down.
+ *
+ * The breaker is meant for one caller doing one attempt at a time (a
+ * connection manager), so allowRequest() does not reserve the trial.
+ *
+ * Usage:
+ *   CircuitBreaker connectBreaker(5, 300000);  // 5 failures → pause 5 minutes
+ *
+ *   if (connectBreaker.allowRequest(now)) {
+ *     startAttempt();
+ *   }
+ *
+ *   // When the attempt finishes
+ *   if (ok) connectBreaker.recordSuccess();
+ *   else connectBreaker.recordFailure(now);
+ */
+template<typename TimeSource = MillisTimeSource>
+class BasicCircuitBreaker {
+private:
+  uint16_t threshold;
+  uint16_t failures;
+  unsigned long coolDown;
+  unsigned long openedAt;
+  bool open;
+  unsigned long tripCount;
+
+public:
+  static const uint16_t DEFAULT_FAILURE_THRESHOLD = 5;
+  static const unsigned long DEFAULT_COOL_DOWN = 300000;  // ms (5 minutes)
+
+  /**
+   * Create a closed breaker
+   * @param failureThreshold Consecutive failures that open the circuit
+   * @param coolDownMs How long the circuit stays open
+   */
+  BasicCircuitBreaker(uint16_t failureThreshold = DEFAULT_FAILURE_THRESHOLD,
+                      unsigned long coolDownMs = DEFAULT_COOL_DOWN)
+    : threshold(failureThreshold), failures(0), coolDown(coolDownMs),
+      openedAt(0), open(false), tripCount(0) {}
+
+  /**
+   * Check if an attempt may be made now (closed or half-open)
+   */
+  bool allowRequest(unsigned long now) const {
+    return getState(now) != CIRCUIT_OPEN;
+  }
+
+  /**
+   * Check if an attempt may be made using the current time
+   */
+  bool allowRequest() const {
+    return allowRequest(TimeSource::now());
+  }
+
+  /**
+   * Record a successful attempt - closes the circuit
+   */
+  void recordSuccess() {
+    failures = 0;
+    open = false;
+  }
+
+  /**
+   * Record a failed attempt
+   * Returns true if this failure opened the circuit
+   */
+  bool recordFailure(unsigned long now) {
+    if (failures < 0xFFFF) failures++;
+
+    // A failed trial while half-open, or too many failures while closed
+    if (open || failures >= threshold) {
+      open = true;
+      openedAt = now;
+      tripCount++;
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * Record a failed attempt at the current time
+   */
+  bool recordFailure() {
+    return recordFailure(TimeSource::now());
+  }
+
+  /**
+   * Get the circuit state at the given timestamp
+   */
+  CircuitState getState(unsigned long now) const {
+    if (!open) return CIRCUIT_CLOSED;
+    return (now - openedAt >= coolDown) ? CIRCUIT_HALF_OPEN : CIRCUIT_OPEN;
+  }
+
+  /**
+   * Get the circuit state using the current time
+   */
+  CircuitState getState() const {
+    return getState(TimeSource::now());
+  }
+
+  /**
+   * Time until the circuit becomes half-open (0 unless open)
+   */
+  unsigned long remainingCoolDown(unsigned long now) const {
+    if (!open) return 0;
+    unsigned long elapsed = now - openedAt;
+    return elapsed >= coolDown ? 0 : coolDown - elapsed;
+  }
+
+  /**
+   * Consecutive failures since the last success
+   */
+  uint16_t getFailures() const {
+    return failures;
+  }
+
+  /**
+   * Number of times the circuit has opened
+   */
+  unsigned long getTripCount() const {
+    return tripCount;
+  }
+
+  /**
+   * Set consecutive failures that open the circuit
+   */
+  void setThreshold(uint16_t failureThreshold) {
+    threshold = failureThreshold;
+  }
+
+  /**
+   * Set how long the circuit stays open
+   */
+  void setCoolDown(unsigned long ms) {
+    coolDown = ms;
+  }
+
+  /**
+   * Get the failure threshold
+   */
+  uint16_t getThreshold() const {
+    return threshold;
+  }
+
+  /**
+   * Get the cool-down period
+   */
+  unsigned long getCoolDown() const {
+    return coolDown;
+  }
+};
+
+typedef BasicCircuitBreaker<> CircuitBreaker;
+
+} // namespace MooreArduino
+
+#endif // MOORE_CIRCUIT_BREAKER_H
@@ -0,0 +1,241 @@
+#ifndef MOORE_CLOCK_H
+#define MOORE_CLOCK_H
+
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_MBED)
+#include <mbed.h>
+#endif
+
+namespace MooreArduino {
+
+/**
+ * Time source policies
+ * 
+ * Every timing component takes its notion of "now" from a TimeSource
+ * template parameter: any type with a `time_type` typedef and a static
+ * `time_type now()`.
+ * Sources also provide `idle(maxMs)`, which rests the CPU for at most
+ * maxMs (returning early on an interrupt where the platform allows), and
+ * an ISR-safe `wake()` that cuts such an idle period short.
+ * 
+ * - MillisTimeSource: the board clock (millis()), used by default
+ * - VirtualTimeSource: a manually advanced clock for host-side simulation,
+ *   so a 30 second timeout can be tested with a single advance(30000)
+ * - WideTimeSource<Source>: widens a 32-bit source to a 64-bit monotonic
+ *   count by tracking its wraps (Millis64TimeSource for millis())
+ * 
+ * Usage:
+ *   BasicTimer<VirtualTimeSource> timeout(30000);
+ *   timeout.start();
+ *   VirtualTimeSource::advance(30000);
+ *   timeout.expired();  // true, no real waiting involved
+ */
+struct MillisTimeSource {
+  typedef unsigned long time_type;
+
+  static unsigned long now() {
+    return millis();
+  }
+
+#if defined(ARDUINO_ARCH_MBED)
+  static const uint32_t WAKE_FLAG = 0x40000000UL;  // Thread flag used by wake()
+
+  static void idle(unsigned long maxMs) {
+    // Block on a thread flag so the RTOS idle thread can sleep the core
+    sleeper() = osThreadGetId();
+    rtos::ThisThread::flags_wait_any_for(WAKE_FLAG, std::chrono::milliseconds(maxMs));
+  }
+
+  static void wake() {
+    osThreadId_t thread = sleeper();
+    if (thread) {
+      osThreadFlagsSet(thread, WAKE_FLAG);
+    }
+  }
+
+private:
+  static osThreadId_t& sleeper() {
+    static osThreadId_t thread = nullptr;
+    return thread;
+  }
+#elif defined(__arm__)
+  static void idle(unsigned long maxMs) {
+    (void)maxMs;
+    __asm__ volatile("wfi");  // Any interrupt wakes us, SysTick at least every 1 ms
+  }
+
+  static void wake() {}
+#else
+  static void idle(unsigned long maxMs) {
+    delay(maxMs > 0 ? 1 : 0);  // No portable sleep: yield in 1 ms steps
+  }
+
+  static void wake() {}
+#endif
+};
+
+class VirtualTimeSource {
+public:
+  typedef unsigned long time_type;
+
+  /**
+   * Current virtual time in milliseconds
+   */
+  static unsigned long now() {
+    return current();
+  }
+
+  /**
+   * Jump to an absolute virtual time
+   */
+  static void set(unsigned long ms) {
+    current() = ms;
+  }
+
+  /**
+   * Fast-forward virtual time by the given number of milliseconds
+   */
+  static void advance(unsigned long ms) {
+    current() += ms;
+  }
+
+  /**
+   * Idling in a simulation simply fast-forwards to the deadline
+   */
+  static void idle(unsigned long maxMs) {
+    advance(maxMs);
+  }
+
+  static void wake() {}
+
+private:
+  // Function-local static keeps the library header-only
+  static unsigned long& current() {
+    static unsigned long time = 0;
+    return time;
+  }
+};
+
+/**
+ * 64-bit monotonic time built from a 32-bit source
+ *
+ * millis() wraps every 49.7 days, which caps Timer and AsyncOp intervals
+ * and makes "how long ago" ambiguous on devices that stay up for months.
+ * WideTimeSource counts the wraps of the underlying source, so its now()
+ * never wraps in practice (584 million years of milliseconds).
+ *
+ * A wrap is detected when a reading is smaller than the previous one, so
+ * now() must run at least once per wrap period (every loop easily does)
+ * and only from the main loop - not from an ISR.
+ *
+ * Usage:
+ *   LongTimer maintenance(90UL * 24 * 3600 * 1000);  // 90 days, see Timer.h
+ *   maintenance.start();
+ *
+ *   // Host side: fast-forward through several wraps
+ *   typedef WideTimeSource<VirtualTimeSource> Virtual64;
+ *   for (int i = 0; i < 12; i++) {
+ *     VirtualTimeSource::advance(0x40000000UL);
+ *     Virtual64::now();
+ *   }
+ */
+template<typename Source = MillisTimeSource>
+class WideTimeSource {
+public:
+  typedef uint64_t time_type;
+
+  /**
+   * Current time as a 64-bit count
+   */
+  static uint64_t now() {
+    State& s = state();
+    uint32_t low = (uint32_t)Source::now();  // Only trust 32 bits, even on 64-bit hosts
+    if (low < s.last) {
+      s.high += 0x100000000ULL;
+    }
+    s.last = low;
+    return s.high | low;
+  }
+
+  static void idle(unsigned long maxMs) {
+    Source::idle(maxMs);
+  }
+
+  static void wake() {
+    Source::wake();
+  }
+
+private:
+  struct State {
+    uint64_t high;
+    uint32_t last;
+  };
+
+  static State& state() {
+    static State s = {0, 0};
+    return s;
+  }
+};
+
+typedef WideTimeSource<MillisTimeSource> Millis64TimeSource;
+
+/**
+ * Single time snapshot shared by all timing components
+ *
+ * Reads the TimeSource once per loop iteration so that Timer, Button, AsyncOp
+ * and the transition function all agree on what "now" is. Pass now() to
+ * the time-aware overloads instead of letting each component read the
+ * clock on its own.
+ *
+ * Usage:
+ *   Clock clock;
+ *
+ *   void loop() {
+ *     unsigned long now = clock.update();  // One clock read per iteration
+ *
+ *     if (heartbeat.expired(now)) {
+ *       heartbeat.restart(now);
+ *     }
+ *     if (powerButton.wasPressed(now)) {
+ *       // Handle press
+ *     }
+ *   }
+ */
+template<typename TimeSource = MillisTimeSource>
+class BasicClock {
+public:
+  typedef typename TimeSource::time_type time_type;
+
+private:
+  time_type current;
+
+public:
+  /**
+   * Create a clock with an empty snapshot (call update() before use)
+   */
+  BasicClock() : current(0) {}
+
+  /**
+   * Capture the current time - call once at the top of loop()
+   * Returns the new snapshot
+   */
+  time_type update() {
+    current = TimeSource::now();
+    return current;
+  }
+
+  /**
+   * Get the snapshot taken by the last update()
+   */
+  time_type now() const {
+    return current;
+  }
+};
+
+typedef BasicClock<> Clock;
+typedef BasicClock<Millis64TimeSource> LongClock;
+
+} // namespace MooreArduino
+
+#endif // MOORE_CLOCK_H
@@ -0,0 +1,263 @@
+#ifndef MOORE_GESTURE_H
+#define MOORE_GESTURE_H
+
+#include <Arduino.h>
+#include "Clock.h"
+
+namespace MooreArduino {
+
+/**
+ * Gestures recognised on a single button
+ */
+enum GestureType {
+  GESTURE_NONE,
+  GESTURE_CLICK,         // Short press with no second press following it
+  GESTURE_DOUBLE_CLICK,  // Second press within the double-click gap
+  GESTURE_LONG_PRESS,    // Held for the long-press time (once per hold)
+  GESTURE_REPEAT         // Still held: repeats every repeat interval after a long press
+};
+
+/**
+ * Click / double-click / long-press / auto-repeat recognizer
+ *
+ * One tiny state machine per button, fed with debounced edges. It needs
+ * no Timer objects of its own: deadlines are derived from the edge
+ * timestamps and checked whenever update() or poll() runs.
+ *
+ * Works with any debounced source - Button, InterruptButton or one bit of
+ * a ButtonBank - either by passing the debounced level every loop, or by
+ * reporting edges with press()/release() and calling poll(now). Sampling
+ * the level misses a click whose press and release both fall inside one
+ * slow iteration; edges with their real times (InterruptButton::nextEdge)
+ * do not. getGestureTime() tells when the last gesture was complete, which
+ * can be well before the call that reported it.
+ *
+ * Usage:
+ *   Button modeButton(2);
+ *   GestureDetector modeGestures;
+ *
+ *   modeButton.update(now);
+ *   switch (modeGestures.update(modeButton.isPressed(), now)) {
+ *     case GESTURE_CLICK:       machine.step(stamp(Input::nextMode(), now), now); break;
+ *     case GESTURE_LONG_PRESS:  machine.step(stamp(Input::factoryReset(), now), now); break;
+ *     default: break;
+ *   }
+ */
+template<typename TimeSource = MillisTimeSource>
+class BasicGestureDetector {
+private:
+  enum Phase {
+    PHASE_IDLE,        // Released, nothing pending
+    PHASE_DOWN,        // First press, long press not reached yet
+    PHASE_UP_WAIT,     // Released after a short press, waiting for a second one
+    PHASE_DOWN_AGAIN,  // Second press of a double click, waiting for release
+    PHASE_HELD         // Long press reported, auto-repeating until release
+  };
+
+  uint8_t phase;
+  bool lastLevel;
+  unsigned long phaseStart;
+  unsigned long lastRepeat;
+  unsigned long gestureTime;
+  unsigned long doubleClickGap;
+  unsigned long longPressTime;
+  unsigned long repeatInterval;
+
+public:
+  static const unsigned long DEFAULT_DOUBLE_CLICK_GAP = 300; // ms
+  static const unsigned long DEFAULT_LONG_PRESS_TIME = 800;  // ms
+  static const unsigned long DEFAULT_REPEAT_INTERVAL = 0;    // ms, 0 = no auto-repeat
+
+  /**
+   * Create a recognizer
+   * @param doubleClickMs Max release-to-press gap for a double click (0 disables it)
+   * @param longPressMs Hold time for a long press
+   * @param repeatMs Auto-repeat period after a long press (0 disables it)
+   */
+  BasicGestureDetector(unsigned long doubleClickMs = DEFAULT_DOUBLE_CLICK_GAP,
+                       unsigned long longPressMs = DEFAULT_LONG_PRESS_TIME,
+                       unsigned long repeatMs = DEFAULT_REPEAT_INTERVAL)
+    : phase(PHASE_IDLE), lastLevel(false), phaseStart(0), lastRepeat(0), gestureTime(0),
+      doubleClickGap(doubleClickMs), longPressTime(longPressMs), repeatInterval(repeatMs) {}
+
+  /**
+   * Feed the debounced level (true = pressed) and check deadlines
+   * Call once per loop; returns at most one gesture per call
+   */
+  GestureType update(bool pressed, unsigned long now) {
+    if (pressed != lastLevel) {
+      return pressed ? press(now) : release(now);
+    }
+    return poll(now);
+  }
+
+  /**
+   * Same as update(pressed, now) using the current time
+   */
+  GestureType update(bool pressed) {
+    return update(pressed, TimeSource::now());
+  }
+
+  /**
+   * Report a debounced press edge at the given time
+   */
+  GestureType press(unsigned long at) {
+    lastLevel = true;
+    GestureType gesture = GESTURE_NONE;
+
+    if (phase == PHASE_UP_WAIT) {
+      if (at - phaseStart <= doubleClickGap) {
+        phase = PHASE_DOWN_AGAIN;
+        gestureTime = at;
+        return GESTURE_DOUBLE_CLICK;
+      }
+      gesture = GESTURE_CLICK;  // Gap expired before we were polled
+      gestureTime = phaseStart + doubleClickGap + 1;
+    }
+
+    phase = PHASE_DOWN;
+    phaseStart = at;
+    return gesture;
+  }
+
+  /**
+   * Report a debounced release edge at the given time
+   */
+  GestureType release(unsigned long at) {
+    lastLevel = false;
+
+    if (phase == PHASE_DOWN) {
+      if (at - phaseStart >= longPressTime) {
+        phase = PHASE_IDLE;
+        gestureTime = phaseStart + longPressTime;
+        return GESTURE_LONG_PRESS;  // Held long enough but never polled
+      }
+      if (doubleClickGap == 0) {
+        phase = PHASE_IDLE;
+        gestureTime = at;
+        return GESTURE_CLICK;
+      }
+      phase = PHASE_UP_WAIT;
+      phaseStart = at;
+      return GESTURE_NONE;
+    }
+
+    if (phase == PHASE_DOWN_AGAIN || phase == PHASE_HELD) {
+      phase = PHASE_IDLE;
+    }
+    return GESTURE_NONE;
+  }
+
+  /**
+   * Check time-based gestures (long press, repeat, single click)
+   */
+  GestureType poll(unsigned long now) {
+    switch (phase) {
+      case PHASE_DOWN:
+        if (now - phaseStart >= longPressTime) {
+          phase = PHASE_HELD;
+          lastRepeat = now;
+          gestureTime = phaseStart + longPressTime;
+          return GESTURE_LONG_PRESS;
+        }
+        break;
+
+      case PHASE_HELD:
+        if (repeatInterval > 0 && now - lastRepeat >= repeatInterval) {
+          lastRepeat += repeatInterval;
+          gestureTime = lastRepeat;
+          return GESTURE_REPEAT;
+        }
+        break;
+
+      case PHASE_UP_WAIT:
+        if (now - phaseStart > doubleClickGap) {
+          phase = PHASE_IDLE;
+          gestureTime = phaseStart + doubleClickGap + 1;
+          return GESTURE_CLICK;
+        }
+        break;
+
+      default:
+        break;
+    }
+    return GESTURE_NONE;
+  }
+
+  /**
+   * Time until the next gesture deadline (for TicklessIdle::until)
+   * Returns 0xFFFFFFFF when nothing is pending
+   */
+  unsigned long timeUntilDeadline(unsigned long now) const {
+    unsigned long deadline;
+    switch (phase) {
+      case PHASE_DOWN:    deadline = phaseStart + longPressTime; break;
+      case PHASE_UP_WAIT: deadline = phaseStart + doubleClickGap + 1; break;
+      case PHASE_HELD:
+        if (repeatInterval == 0) return 0xFFFFFFFFUL;
+        deadline = lastRepeat + repeatInterval;
+        break;
+      default:
+        return 0xFFFFFFFFUL;
+    }
+    return (long)(deadline - now) > 0 ? deadline - now : 0;
+  }
+
+  /**
+   * Time the last reported gesture was complete: the second press of a
+   * double click, the end of the double-click gap for a click, the moment
+   * the hold reached the long-press time
+   * Stamp inputs with it so they carry when the gesture happened
+   */
+  unsigned long getGestureTime() const {
+    return gestureTime;
+  }
+
+  /**
+   * Set max release-to-press gap for a double click (0 disables double click)
+   */
+  void setDoubleClickGap(unsigned long ms) {
+    doubleClickGap = ms;
+  }
+
+  /**
+   * Set hold time for a long press
+   */
+  void setLongPressTime(unsigned long ms) {
+    longPressTime = ms;
+  }
+
+  /**
+   * Set auto-repeat period after a long press (0 disables repeat)
+   */
+  void setRepeatInterval(unsigned long ms) {
+    repeatInterval = ms;
+  }
+
+  /**
+   * Get double-click gap
+   */
+  unsigned long getDoubleClickGap() const {
+    return doubleClickGap;
+  }
+
+  /**
+   * Get long-press time
+   */
+  unsigned long getLongPressTime() const {
+    return longPressTime;
+  }
+
+  /**
+   * Get auto-repeat period
+   */
+  unsigned long getRepeatInterval() const {
+    return repeatInterval;
+  }
+};
+
+typedef BasicGestureDetector<> GestureDetector;
+
+} // namespace MooreArduino
+
+#endif // MOORE_GESTURE_H
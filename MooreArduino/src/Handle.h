@@ -0,0 +1,53 @@
+#ifndef MOORE_HANDLE_H
+#define MOORE_HANDLE_H
+
+#include <Arduino.h>
+
+namespace MooreArduino {
+
+/**
+ * Generation-checked reference into a fixed-capacity pool
+ *
+ * Pools hand out a Handle instead of a pointer. The generation counter is
+ * bumped every time a slot is reused, so a Handle kept after its entry
+ * fired or was cancelled is recognised as stale instead of silently
+ * referring to a newer entry.
+ *
+ * Usage:
+ *   Handle h = wheel.schedule(5000, Input::timeout());
+ *   if (h.isValid()) {
+ *     wheel.cancel(h);  // Safe even if the entry already fired
+ *   }
+ */
+struct Handle {
+  static const uint16_t INVALID_INDEX = 0xFFFF;
+
+  uint16_t index;       // Slot in the owning pool
+  uint16_t generation;  // Slot generation when the handle was issued
+
+  /**
+   * Create an invalid handle
+   */
+  Handle() : index(INVALID_INDEX), generation(0) {}
+
+  Handle(uint16_t slot, uint16_t gen) : index(slot), generation(gen) {}
+
+  /**
+   * Check if the handle was issued by a pool (may still be stale)
+   */
+  bool isValid() const {
+    return index != INVALID_INDEX;
+  }
+
+  bool operator==(const Handle& other) const {
+    return index == other.index && generation == other.generation;
+  }
+
+  bool operator!=(const Handle& other) const {
+    return !(*this == other);
+  }
+};
+
+} // namespace MooreArduino
+
+#endif // MOORE_HANDLE_H
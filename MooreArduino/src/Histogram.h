@@ -0,0 +1,175 @@
+#ifndef MOORE_HISTOGRAM_H
+#define MOORE_HISTOGRAM_H
+
+#include <Arduino.h>
+
+namespace MooreArduino {
+
+/**
+ * Fixed-size log-linear histogram for durations and other positive values
+ *
+ * Values 0-3 get a bucket each; above that every power of two is split
+ * into 4 buckets, so a bucket is never wider than 25% of its value.
+ * 60 buckets reach 65535 (about a minute of milliseconds); larger values
+ * land in the last bucket. record() is a handful of shifts, and the whole
+ * histogram is a plain array of counters that can be stored in flash and
+ * loaded again as-is.
+ *
+ * When a bucket would overflow, all counts are halved: old samples fade
+ * out gradually and the percentiles follow a changing environment.
+ *
+ * Usage:
+ *   Histogram<> connectTimes;
+ *
+ *   connectTimes.record(elapsedMs);
+ *   if (connectTimes.getCount() >= 10) {
+ *     unsigned long timeout = connectTimes.percentile(99) * 3 / 2;
+ *   }
+ *
+ * Template parameters:
+ *   Buckets - Number of buckets (60 covers 0-65535)
+ */
+template<uint8_t Buckets = 60>
+class Histogram {
+  static_assert(Buckets >= 4, "Histogram needs at least 4 buckets");
+
+private:
+  uint16_t counts[Buckets];
+
+public:
+  /**
+   * Create an empty histogram
+   */
+  Histogram() {
+    clear();
+  }
+
+  /**
+   * Drop all samples
+   */
+  void clear() {
+    for (uint8_t i = 0; i < Buckets; i++) {
+      counts[i] = 0;
+    }
+  }
+
+  /**
+   * Add one sample
+   */
+  void record(unsigned long value) {
+    uint8_t bucket = bucketFor(value);
+    if (counts[bucket] == 0xFFFF) {
+      decay();
+    }
+    counts[bucket]++;
+  }
+
+  /**
+   * Halve every count (ages out old samples)
+   */
+  void decay() {
+    for (uint8_t i = 0; i < Buckets; i++) {
+      counts[i] >>= 1;
+    }
+  }
+
+  /**
+   * Total number of samples
+   */
+  unsigned long getCount() const {
+    unsigned long total = 0;
+    for (uint8_t i = 0; i < Buckets; i++) {
+      total += counts[i];
+    }
+    return total;
+  }
+
+  /**
+   * Check if there are no samples
+   */
+  bool isEmpty() const {
+    return getCount() == 0;
+  }
+
+  /**
+   * Value below which `percent` percent of samples fall
+   * Reports the top of the bucket, so the answer errs on the high side;
+   * in the open-ended last bucket that is 0xFFFFFFFF (see rangeLimit())
+   * Returns 0 for an empty histogram
+   */
+  unsigned long percentile(uint8_t percent) const {
+    unsigned long total = getCount();
+    if (total == 0) return 0;
+    if (percent > 100) percent = 100;
+
+    // Rank of the sample we are looking for (1-based, rounded up)
+    unsigned long rank = (total * percent + 99) / 100;
+    if (rank == 0) rank = 1;
+
+    unsigned long seen = 0;
+    for (uint8_t i = 0; i < Buckets; i++) {
+      seen += counts[i];
+      if (seen >= rank) {
+        return upperBound(i);
+      }
+    }
+    return upperBound(Buckets - 1);
+  }
+
+  /**
+   * Number of samples in bucket i
+   */
+  uint16_t getBucketCount(uint8_t i) const {
+    return i < Buckets ? counts[i] : 0;
+  }
+
+  /**
+   * Smallest value that lands in bucket i
+   */
+  static unsigned long lowerBound(uint8_t i) {
+    if (i < 4) return i;
+    uint8_t octave = i / 4 + 1;  // Position of the value's top bit
+    return (4UL + (i & 3)) << (octave - 2);
+  }
+
+  /**
+   * Largest value that lands in bucket i (0xFFFFFFFF for the last one)
+   */
+  static unsigned long upperBound(uint8_t i) {
+    return (i + 1 < Buckets) ? lowerBound(i + 1) - 1 : 0xFFFFFFFFUL;
+  }
+
+  /**
+   * Bucket a value lands in
+   */
+  static uint8_t bucketFor(unsigned long value) {
+    if (value < 4) return (uint8_t)value;
+
+    uint8_t octave = 2;
+    while (octave < 31 && (value >> (octave + 1)) != 0) {
+      octave++;
+    }
+    uint8_t sub = (value >> (octave - 2)) & 3;
+    unsigned long bucket = 4UL * (octave - 1) + sub;
+    return bucket < Buckets ? (uint8_t)bucket : Buckets - 1;
+  }
+
+  /**
+   * Smallest value of the open-ended last bucket
+   * A percentile at or above it only says "at least rangeLimit()"
+   */
+  static unsigned long rangeLimit() {
+    return lowerBound(Buckets - 1);
+  }
+
+  /**
+   * Number of buckets
+   */
+  static uint8_t getBuckets() {
+    return Buckets;
+  }
+};
+
+} // namespace MooreArduino
+
+#endif // MOORE_HISTOGRAM_H
@@ -0,0 +1,153 @@
+#ifndef MOORE_INPUT_TRACE_H
+#define MOORE_INPUT_TRACE_H
+
+#include <Arduino.h>
+#include "MooreMachine.h"
+
+namespace MooreArduino {
+
+/**
+ * Fixed-size recording of the inputs a MooreMachine received
+ *
+ * δ is pure and takes its time from the input, so a machine started from
+ * the same q₀ and fed the same inputs goes through the same states and
+ * produces the same outputs. The trace keeps inputs in the order they were
+ * stepped, from the moment recording starts: once full, further inputs are
+ * counted as dropped rather than overwriting old ones, because a replay
+ * needs the beginning of the run to reach the right states.
+ *
+ * Inputs are stored as-is. For large Input types, record a reduced copy or
+ * encode inputs into a byte buffer instead; replay() works with anything
+ * that has rewind() and next(Input&).
+ *
+ * Usage:
+ *   InputTrace<Input, 256> trace;
+ *   void recordInput(const Input& input) { trace.record(input); }
+ *
+ *   machine.setInputRecorder(recordInput);
+ *
+ *   // Later, e.g. on a PC: a fresh machine with the same δ, λ and q₀
+ *   MooreMachine<AppState, Input, Output> replica(transitionFunction, AppState());
+ *   replica.setOutputFunction(outputFunction);
+ *   trace.rewind();
+ *   replay(replica, trace, printStep);
+ *
+ * Template parameters:
+ *   Input - The machine's input alphabet Σ
+ *   Capacity - Maximum number of inputs kept
+ */
+template<typename Input, uint16_t Capacity>
+class InputTrace {
+  static_assert(Capacity > 0, "InputTrace needs room for at least one input");
+
+private:
+  Input inputs[Capacity];
+  uint16_t count;
+  uint16_t cursor;          // Next input returned by next()
+  unsigned long dropped;
+
+public:
+  /**
+   * Create an empty trace
+   */
+  InputTrace() : count(0), cursor(0), dropped(0) {}
+
+  /**
+   * Append one input
+   * Returns false (and counts the input as dropped) if the trace is full
+   */
+  bool record(const Input& input) {
+    if (count >= Capacity) {
+      dropped++;
+      return false;
+    }
+    inputs[count++] = input;
+    return true;
+  }
+
+  /**
+   * Read the next recorded input, oldest first
+   * Returns false once every input has been read
+   */
+  bool next(Input& input) {
+    if (cursor >= count) {
+      return false;
+    }
+    input = inputs[cursor++];
+    return true;
+  }
+
+  /**
+   * Start reading from the oldest input again
+   */
+  void rewind() {
+    cursor = 0;
+  }
+
+  /**
+   * Drop all inputs and the dropped count
+   */
+  void clear() {
+    count = 0;
+    cursor = 0;
+    dropped = 0;
+  }
+
+  /**
+   * Number of inputs recorded
+   */
+  uint16_t size() const {
+    return count;
+  }
+
+  /**
+   * Maximum number of inputs the trace can hold
+   */
+  uint16_t getCapacity() const {
+    return Capacity;
+  }
+
+  /**
+   * Check if further inputs will be dropped
+   */
+  bool isFull() const {
+    return count >= Capacity;
+  }
+
+  /**
+   * Number of inputs that did not fit
+   * A replay only reproduces the run up to the first dropped input
+   */
+  unsigned long getDropped() const {
+    return dropped;
+  }
+};
+
+/**
+ * Feed every input of a trace into a machine
+ * Runs δ for each input and λ after it; effects are not executed, so the
+ * machine needs no hardware. Use a machine without an input recorder.
+ *
+ * @param machine Machine with the same δ, λ and q₀ as the recorded one
+ * @param trace Any source with bool next(Input&), read from its current position
+ * @param onStep Optional callback with each input, the state after it and λ of that state
+ * @return Number of inputs replayed
+ */
+template<typename State, typename Input, typename Output, typename Trace>
+unsigned long replay(MooreMachine<State, Input, Output>& machine, Trace& trace,
+                     void (*onStep)(const Input&, const State&, const Output&) = nullptr) {
+  unsigned long steps = 0;
+  Input input;
+  while (trace.next(input)) {
+    machine.step(input);
+    if (onStep) {
+      onStep(input, machine.getState(), machine.getCurrentOutput());
+    }
+    steps++;
+  }
+  return steps;
+}
+
+} // namespace MooreArduino
+
+#endif // MOORE_INPUT_TRACE_H
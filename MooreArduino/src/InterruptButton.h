@@ -0,0 +1,298 @@
+#ifndef MOORE_INTERRUPT_BUTTON_H
+#define MOORE_INTERRUPT_BUTTON_H
+
+#include <Arduino.h>
+#include "Clock.h"
+
+namespace MooreArduino {
+
+/**
+ * Interrupt-backed debounced button
+ *
+ * A pin-change interrupt timestamps every edge into a small lock-free ring
+ * buffer. update() drains the buffer and debounces on those timestamps, so
+ * a press that starts and ends while loop() is blocked in an effect is
+ * still reported, and getLastPressTime() tells when it really happened.
+ *
+ * The debounced edges are queued with their times as well: nextEdge()
+ * hands them out one by one, e.g. to GestureDetector::press()/release(),
+ * so a whole click inside one blocked iteration is seen as a click.
+ *
+ * attachInterrupt() needs a plain function, so the sketch provides a tiny
+ * ISR that forwards to onEdge() (and may wake a TicklessIdle).
+ *
+ * Usage:
+ *   InterruptButton powerButton(2);
+ *
+ *   void powerButtonISR() {
+ *     powerButton.onEdge();
+ *     idle.wake();
+ *   }
+ *
+ *   void setup() {
+ *     powerButton.begin(powerButtonISR);
+ *   }
+ *
+ *   void loop() {
+ *     if (powerButton.wasPressed(now)) {
+ *       machine.step(stamp(Input::powerToggle(), powerButton.getLastPressTime()), now);
+ *     }
+ *   }
+ *
+ *   // Or edge by edge, with the time each one happened
+ *   bool pressed;
+ *   InterruptButton::time_type at;
+ *   powerButton.update(now);
+ *   while (powerButton.nextEdge(pressed, at)) {
+ *     GestureType gesture = pressed ? gestures.press(at) : gestures.release(at);
+ *     // ...
+ *   }
+ *
+ * Template parameters:
+ *   TimeSource - Where "now" comes from (see Clock.h)
+ *   BufferSize - Edges buffered between updates, raw and debounced (power of two)
+ */
+template<typename TimeSource = MillisTimeSource, uint8_t BufferSize = 16>
+class BasicInterruptButton {
+  static_assert((BufferSize & (BufferSize - 1)) == 0, "BufferSize must be a power of two");
+
+public:
+  typedef typename TimeSource::time_type time_type;
+
+private:
+  static const uint8_t MASK = BufferSize - 1;
+
+  int pin;
+  time_type debounceDelay;
+
+  // Ring buffer: ISR writes head, update() writes tail
+  volatile time_type edgeTimes[BufferSize];
+  volatile uint8_t edgeLevels[BufferSize];
+  volatile uint8_t head;
+  volatile uint8_t tail;
+  volatile bool overflowed;
+  unsigned long overflowCount;
+
+  // Debouncer state, only touched by update()
+  bool currentState;         // Accepted (debounced) level
+  bool candidateState;       // Level waiting to prove it is stable
+  time_type candidateTime;
+  bool hasCandidate;
+  uint8_t pendingPresses;    // Presses not yet consumed by wasPressed()
+  time_type lastPressTime;
+
+  // Debounced edges not yet taken by nextEdge()
+  time_type acceptedTimes[BufferSize];
+  bool acceptedPressed[BufferSize];
+  uint8_t acceptedHead;
+  uint8_t acceptedCount;
+  unsigned long droppedEdges;
+
+public:
+  static const unsigned long DEFAULT_DEBOUNCE_DELAY = 50; // ms
+
+  /**
+   * Create a button on the specified pin
+   * Sets up INPUT_PULLUP mode automatically; call begin() to attach the ISR
+   */
+  BasicInterruptButton(int pinNumber, time_type debounceMs = DEFAULT_DEBOUNCE_DELAY)
+    : pin(pinNumber), debounceDelay(debounceMs), head(0), tail(0),
+      overflowed(false), overflowCount(0), currentState(HIGH), candidateState(HIGH),
+      candidateTime(0), hasCandidate(false), pendingPresses(0), lastPressTime(0),
+      acceptedHead(0), acceptedCount(0), droppedEdges(0) {
+    pinMode(pin, INPUT_PULLUP);
+  }
+
+  /**
+   * Attach the pin-change interrupt
+   * @param isr Sketch function that calls onEdge() on this button
+   */
+  void begin(void (*isr)()) {
+    currentState = digitalRead(pin);
+    candidateState = currentState;
+    attachInterrupt(digitalPinToInterrupt(pin), isr, CHANGE);
+  }
+
+  /**
+   * Record an edge - call from the pin's interrupt handler only
+   */
+  void onEdge() {
+    uint8_t next = (head + 1) & MASK;
+    if (next == tail) {
+      overflowed = true;  // Drop the edge; update() resynchronises from the pin
+      return;
+    }
+    edgeTimes[head] = TimeSource::now();
+    edgeLevels[head] = digitalRead(pin);
+    head = next;  // Publish only after the slot is written
+  }
+
+  /**
+   * Drain buffered edges and debounce them
+   * Returns true if the debounced state changed
+   */
+  bool update(time_type now) {
+    bool changed = false;
+
+    while (tail != head) {
+      time_type time = edgeTimes[tail];
+      bool level = edgeLevels[tail];
+      tail = (tail + 1) & MASK;
+
+      // The previous level held until this edge - accept it if it was stable long enough
+      if (hasCandidate && time - candidateTime > debounceDelay) {
+        changed |= accept();
+      }
+      candidateState = level;
+      candidateTime = time;
+      hasCandidate = true;
+    }
+
+    if (overflowed) {
+      overflowed = false;
+      overflowCount++;
+      candidateState = digitalRead(pin);
+      candidateTime = now;
+      hasCandidate = true;
+    }
+
+    // No edge since the candidate: accept once it has settled
+    if (hasCandidate && now - candidateTime > debounceDelay) {
+      changed |= accept();
+    }
+
+    return changed;
+  }
+
+  /**
+   * Update the button state using the current time
+   */
+  bool update() {
+    return update(TimeSource::now());
+  }
+
+  /**
+   * Update and return true once for every press since the last call
+   * Presses that already ended are still reported
+   */
+  bool wasPressed(time_type now) {
+    update(now);
+    if (pendingPresses == 0) {
+      return false;
+    }
+    pendingPresses--;
+    return true;
+  }
+
+  /**
+   * Same as wasPressed(now) using the current time
+   */
+  bool wasPressed() {
+    return wasPressed(TimeSource::now());
+  }
+
+  /**
+   * Take the oldest debounced edge not yet taken (call update() first)
+   * @param pressed Receives true for a press, false for a release
+   * @param at Receives the time the edge happened, not when it was read
+   * @return false if no edge is waiting
+   */
+  bool nextEdge(bool& pressed, time_type& at) {
+    if (acceptedCount == 0) {
+      return false;
+    }
+    pressed = acceptedPressed[acceptedHead];
+    at = acceptedTimes[acceptedHead];
+    acceptedHead = (acceptedHead + 1) & MASK;
+    acceptedCount--;
+    return true;
+  }
+
+  /**
+   * Check if debounced edges are waiting for nextEdge()
+   */
+  bool hasEdges() const {
+    return acceptedCount > 0;
+  }
+
+  /**
+   * Get how many debounced edges were dropped because nobody took them
+   */
+  unsigned long getDroppedEdges() const {
+    return droppedEdges;
+  }
+
+  /**
+   * Check if button is currently pressed (after debouncing)
+   */
+  bool isPressed() const {
+    return currentState == LOW;
+  }
+
+  /**
+   * Get the timestamp of the edge that started the last press
+   * Use it to stamp inputs so latency reflects the real press time
+   */
+  time_type getLastPressTime() const {
+    return lastPressTime;
+  }
+
+  /**
+   * Get how many times the edge buffer overflowed
+   */
+  unsigned long getOverflowCount() const {
+    return overflowCount;
+  }
+
+  /**
+   * Set debounce delay in milliseconds
+   */
+  void setDebounceDelay(time_type ms) {
+    debounceDelay = ms;
+  }
+
+  /**
+   * Get current debounce delay
+   */
+  time_type getDebounceDelay() const {
+    return debounceDelay;
+  }
+
+  /**
+   * Get the pin number this button is on
+   */
+  int getPin() const {
+    return pin;
+  }
+
+private:
+  /**
+   * Promote the stable candidate to the debounced state
+   */
+  bool accept() {
+    hasCandidate = false;
+    if (candidateState == currentState) {
+      return false;
+    }
+    currentState = candidateState;
+    if (currentState == LOW) {
+      lastPressTime = candidateTime;
+      if (pendingPresses < 255) pendingPresses++;
+    }
+    if (acceptedCount < BufferSize) {
+      uint8_t slot = (acceptedHead + acceptedCount) & MASK;
+      acceptedTimes[slot] = candidateTime;
+      acceptedPressed[slot] = (currentState == LOW);
+      acceptedCount++;
+    } else {
+      droppedEdges++;  // Keep the oldest: they come out in order
+    }
+    return true;
+  }
+};
+
+typedef BasicInterruptButton<> InterruptButton;
+
+} // namespace MooreArduino
+
+#endif // MOORE_INTERRUPT_BUTTON_H
@@ -0,0 +1,206 @@
+#ifndef MOORE_LINK_MONITOR_H
+#define MOORE_LINK_MONITOR_H
+
+#include <Arduino.h>
+#include "Clock.h"
+
+namespace MooreArduino {
+
+/**
+ * Link quality changes reported by LinkMonitor::sample()
+ */
+enum LinkEvent {
+  LINK_EVENT_NONE,       // No change
+  LINK_EVENT_DEGRADED,   // Smoothed value fell below the degraded threshold
+  LINK_EVENT_RECOVERED   // Smoothed value rose above the recovered threshold
+};
+
+/**
+ * Smoothed signal strength monitor with hysteresis
+ *
+ * Samples a noisy link metric (typically RSSI in dBm) at a fixed rate,
+ * smooths it with an exponentially weighted moving average, and reports
+ * a change only when the average crosses a threshold: below
+ * `degradedBelow` the link is degraded, and it only counts as recovered
+ * once the average climbs above `recoveredAbove`. The gap between the two
+ * keeps a link hovering around one value from flapping.
+ *
+ * The average is kept in fixed point (1/256 units) and each sample moves
+ * it 1/2^smoothingShift of the way towards the new value: no floats, no
+ * buffers. The monitor does not read the hardware itself - the input
+ * layer asks sampleDue(now), reads the metric, and turns the returned
+ * event into a machine input.
+ *
+ * Usage:
+ *   LinkMonitor link(-75, -68, 2000);  // Degraded below -75, recovered above -68, sample every 2s
+ *
+ *   // In the input layer, while connected
+ *   if (link.sampleDue(now)) {
+ *     switch (link.sample(WiFi.RSSI(), now)) {
+ *       case LINK_EVENT_DEGRADED:  return stamp(Input::linkDegraded(link.getSmoothed()), now);
+ *       case LINK_EVENT_RECOVERED: return stamp(Input::linkRecovered(link.getSmoothed()), now);
+ *       default: break;
+ *     }
+ *   }
+ *
+ *   // When the link goes away
+ *   link.reset();
+ */
+template<typename TimeSource = MillisTimeSource>
+class BasicLinkMonitor {
+private:
+  int16_t degradedBelow;
+  int16_t recoveredAbove;
+  unsigned long interval;
+  uint8_t shift;
+  int32_t average;           // Smoothed value × 256
+  unsigned long lastSample;
+  uint16_t samples;
+  bool degraded;
+
+public:
+  static const unsigned long DEFAULT_SAMPLE_INTERVAL = 1000;  // ms
+  static const uint8_t DEFAULT_SMOOTHING_SHIFT = 3;            // Each sample weighs 1/8
+
+  /**
+   * Create a monitor with no samples yet
+   * @param degradedThreshold Average below this reports LINK_EVENT_DEGRADED
+   * @param recoveredThreshold Average above this reports LINK_EVENT_RECOVERED
+   * @param intervalMs Time between samples
+   * @param smoothingShift Each sample weighs 1/2^smoothingShift (0 = no smoothing)
+   */
+  BasicLinkMonitor(int16_t degradedThreshold, int16_t recoveredThreshold,
+                   unsigned long intervalMs = DEFAULT_SAMPLE_INTERVAL,
+                   uint8_t smoothingShift = DEFAULT_SMOOTHING_SHIFT)
+    : degradedBelow(degradedThreshold),
+      recoveredAbove(recoveredThreshold < degradedThreshold ? degradedThreshold : recoveredThreshold),
+      interval(intervalMs), shift(smoothingShift > 15 ? 15 : smoothingShift),
+      average(0), lastSample(0), samples(0), degraded(false) {}
+
+  /**
+   * Check if the next sample should be taken
+   */
+  bool sampleDue(unsigned long now) const {
+    return samples == 0 || now - lastSample >= interval;
+  }
+
+  /**
+   * Check if the next sample should be taken using the current time
+   */
+  bool sampleDue() const {
+    return sampleDue(TimeSource::now());
+  }
+
+  /**
+   * Feed one sample and report a threshold crossing, if any
+   */
+  LinkEvent sample(int16_t value, unsigned long now) {
+    int32_t scaled = (int32_t)value * 256;
+    if (samples == 0) {
+      average = scaled;  // Start from the first sample, not from 0
+    } else {
+      average += (scaled - average) / (1L << shift);
+    }
+    lastSample = now;
+    if (samples < 0xFFFF) samples++;
+
+    int16_t smoothed = getSmoothed();
+    if (!degraded && smoothed < degradedBelow) {
+      degraded = true;
+      return LINK_EVENT_DEGRADED;
+    }
+    if (degraded && smoothed > recoveredAbove) {
+      degraded = false;
+      return LINK_EVENT_RECOVERED;
+    }
+    return LINK_EVENT_NONE;
+  }
+
+  /**
+   * Feed one sample taken at the current time
+   */
+  LinkEvent sample(int16_t value) {
+    return sample(value, TimeSource::now());
+  }
+
+  /**
+   * Forget all samples (e.g. after the link went down)
+   * The next sample is due immediately and the link starts as not degraded
+   */
+  void reset() {
+    average = 0;
+    samples = 0;
+    degraded = false;
+  }
+
+  /**
+   * Time until the next sample is due (0 if due now)
+   */
+  unsigned long remainingTime(unsigned long now) const {
+    if (samples == 0) return 0;
+    unsigned long elapsed = now - lastSample;
+    return elapsed >= interval ? 0 : interval - elapsed;
+  }
+
+  /**
+   * Time until the next sample is due (for TicklessIdle::until)
+   */
+  unsigned long timeUntilDeadline(unsigned long now) const {
+    return remainingTime(now);
+  }
+
+  /**
+   * Smoothed value, rounded to the nearest integer (0 before any sample)
+   */
+  int16_t getSmoothed() const {
+    return (int16_t)((average + (average < 0 ? -128 : 128)) / 256);
+  }
+
+  /**
+   * Check if the link is currently reported as degraded
+   */
+  bool isDegraded() const {
+    return degraded;
+  }
+
+  /**
+   * Number of samples since the last reset() (saturates at 65535)
+   */
+  uint16_t getSamples() const {
+    return samples;
+  }
+
+  /**
+   * Set the time between samples
+   */
+  void setSampleInterval(unsigned long ms) {
+    interval = ms;
+  }
+
+  /**
+   * Get the time between samples
+   */
+  unsigned long getSampleInterval() const {
+    return interval;
+  }
+
+  /**
+   * Get the degraded threshold
+   */
+  int16_t getDegradedThreshold() const {
+    return degradedBelow;
+  }
+
+  /**
+   * Get the recovered threshold
+   */
+  int16_t getRecoveredThreshold() const {
+    return recoveredAbove;
+  }
+};
+
+typedef BasicLinkMonitor<> LinkMonitor;
+
+} // namespace MooreArduino
+
+#endif // MOORE_LINK_MONITOR_H
@@ -18,7 +18,22 @@
  * - MooreMachine: Core finite state machine implementation
  * - Timer: Non-blocking timer utilities
  * - Button: Debounced button input handling  
+ * - InterruptButton: Interrupt-backed button that never misses short presses
+ * - ButtonBank: Many buttons scanned and debounced together with vertical counters
+ * - GestureDetector: Click, double-click, long-press and auto-repeat on one button
  * - AsyncOp: Async operation tracking with timeouts
+ * - AsyncOpPool: Many concurrent AsyncOps ordered by deadline
+ * - RetryPolicy: Exponential backoff with decorrelated jitter for automatic retries
+ * - RateLimiter: Token bucket bounding how often an action may happen
+ * - CircuitBreaker: Stops retrying a failing operation for a cool-down period
+ * - Histogram: Fixed-size log-linear histogram with percentiles, storable as-is
+ * - LinkMonitor: EWMA-smoothed signal strength with hysteresis thresholds
+ * - StatusFilter: Settle-time filter that keeps driver status flaps out of the machine
+ * - InputTrace: Records a machine's inputs for replay through the same δ/λ
+ * - TraceBuffer: Compact varint-encoded, run-length compressed input records
+ * - Clock: One time snapshot per loop shared by all timing components
+ * - TimerWheel: Hierarchical timing wheel for many timers with nextDeadline()
+ * - TicklessIdle: Sleep until the next deadline or interrupt instead of delay()
  * 
  * Usage:
  *   #include <MooreArduino.h>
@@ -43,7 +58,23 @@
 #include "MooreMachine.h"
 #include "Timer.h"
 #include "Button.h"
+#include "InterruptButton.h"
+#include "ButtonBank.h"
+#include "Gesture.h"
 #include "AsyncOp.h"
+#include "Clock.h"
+#include "Handle.h"
+#include "TimerWheel.h"
+#include "AsyncOpPool.h"
+#include "RetryPolicy.h"
+#include "RateLimiter.h"
+#include "CircuitBreaker.h"
+#include "Histogram.h"
+#include "LinkMonitor.h"
+#include "StatusFilter.h"
+#include "InputTrace.h"
+#include "TraceBuffer.h"
+#include "TicklessIdle.h"
 
 // Version info
 #define MOORE_ARDUINO_VERSION_MAJOR 1
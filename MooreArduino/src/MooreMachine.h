@@ -48,6 +48,28 @@ namespace MooreArduino {
  *   executeOutput(effect);  // Handle effects in main loop
  *   Input input = readEnvironment();
  *   machine.step(input);
+ * 
+ * Timestamped inputs:
+ *   δ must not read the clock itself - otherwise replaying the same input
+ *   sequence yields different states. Instead, give Input a `timestamp`
+ *   member, stamp it when the event is captured, and read input.timestamp
+ *   inside δ:
+ * 
+ *   struct Input { int type; unsigned long timestamp; };
+ *   
+ *   Input input = stamp(readEnvironment(), clock.now());
+ *   machine.step(input, clock.now());  // Also records event-to-transition latency
+ * 
+ * Recording inputs:
+ *   Because δ is pure and reads time only from the input, the sequence of
+ *   inputs is all it takes to reproduce a run. An input recorder sees every
+ *   input before δ; keep them in an InputTrace and replay() them later
+ *   (e.g. on a PC) through the same δ and λ:
+ * 
+ *   InputTrace<Input, 256> trace;
+ *   void recordInput(const Input& input) { trace.record(input); }
+ *   
+ *   machine.setInputRecorder(recordInput);
  */
 template<typename State, typename Input, typename Output>
 class MooreMachine {
@@ -56,6 +78,7 @@ public:
   typedef State (*TransitionFunction)(const State&, const Input&);  // δ: Q × Σ → Q
   typedef Output (*OutputFunction)(const State&);                   // λ: Q → Γ
   typedef void (*StateObserver)(const State&, const State&);        // Observer pattern for state changes
+  typedef void (*InputRecorder)(const Input&);                      // Sees every input σ before δ
 
 private:
   State currentState;                    // Current state q ∈ Q
@@ -66,6 +89,13 @@ private:
   static const int MAX_OBSERVERS = 8;
   StateObserver observers[MAX_OBSERVERS];
   int observerCount;
+  
+  // Optional input recording for later replay
+  InputRecorder recorder;
+  
+  // Event-to-transition latency of timestamped inputs (milliseconds)
+  unsigned long lastLatency;
+  unsigned long maxLatency;
 
 public:
   /**
@@ -75,7 +105,8 @@ public:
    * @param initialState q₀ (initial state)
    */
   MooreMachine(TransitionFunction transitionFunc, const State& initialState)
-    : currentState(initialState), delta(transitionFunc), lambda(nullptr), observerCount(0) {
+    : currentState(initialState), delta(transitionFunc), lambda(nullptr), observerCount(0),
+      recorder(nullptr), lastLatency(0), maxLatency(0) {
     // Initialize observer array to null
     for (int i = 0; i < MAX_OBSERVERS; i++) {
       observers[i] = nullptr;
@@ -91,6 +122,11 @@ public:
     
     State oldState = currentState;
     
+    // Record the input before it takes effect
+    if (recorder) {
+      recorder(input);
+    }
+    
     // Apply input to current state via transition function δ
     currentState = delta(currentState, input);
     
@@ -98,6 +134,43 @@ public:
     notifyObservers(oldState, currentState);
   }
 
+  /**
+   * Process a timestamped input and record how long it waited
+   * Requires Input to have a `timestamp` member set at capture time
+   * 
+   * @param input Input symbol σ stamped with its capture time
+   * @param now Time at which the step is executed
+   */
+  void step(const Input& input, unsigned long now) {
+    lastLatency = now - input.timestamp;
+    if (lastLatency > maxLatency) {
+      maxLatency = lastLatency;
+    }
+    step(input);
+  }
+
+  /**
+   * Get latency of the most recent timestamped step (milliseconds)
+   */
+  unsigned long getLastLatency() const {
+    return lastLatency;
+  }
+
+  /**
+   * Get the worst latency seen since the last resetLatency() (milliseconds)
+   */
+  unsigned long getMaxLatency() const {
+    return maxLatency;
+  }
+
+  /**
+   * Clear recorded latency statistics
+   */
+  void resetLatency() {
+    lastLatency = 0;
+    maxLatency = 0;
+  }
+
   /**
    * Get current state q (read-only)
    */
@@ -124,6 +197,14 @@ public:
     lambda = outputFunc;
   }
 
+  /**
+   * Set a function that receives every input before it is applied
+   * Pass nullptr to stop recording
+   */
+  void setInputRecorder(InputRecorder inputRecorder) {
+    recorder = inputRecorder;
+  }
+
   /**
    * Add a state observer function
    * Observers are notified whenever the machine transitions to a new state
@@ -177,6 +258,19 @@ private:
   }
 };
 
+/**
+ * Stamp an input with its capture time
+ * Works with any Input type that has a `timestamp` member
+ * 
+ * Usage:
+ *   return stamp(Input::tick(), now);
+ */
+template<typename Input>
+Input stamp(Input input, unsigned long timestamp) {
+  input.timestamp = timestamp;
+  return input;
+}
+
 } // namespace MooreArduino
 
 #endif // MOORE_MACHINE_H
@@ -0,0 +1,132 @@
+#ifndef MOORE_RATE_LIMITER_H
+#define MOORE_RATE_LIMITER_H
+
+#include <Arduino.h>
+#include "Clock.h"
+
+namespace MooreArduino {
+
+/**
+ * Token bucket rate limiter
+ *
+ * Allows short bursts of up to `capacity` actions, then at most one
+ * action per refill interval. Use it to bound how often a device may do
+ * something that costs a shared resource - association attempts against
+ * an access point, requests against a server - no matter how often the
+ * rest of the program asks.
+ *
+ * Usage:
+ *   RateLimiter connectLimit(3, 20000);  // Burst of 3, then one per 20s
+ *
+ *   if (reconnect.isDue(now) && connectLimit.tryAcquire(now)) {
+ *     reconnect.due(now);
+ *     return stamp(Input::retryConnection(), now);
+ *   }
+ */
+template<typename TimeSource = MillisTimeSource>
+class BasicRateLimiter {
+private:
+  uint16_t capacity;
+  uint16_t tokens;
+  unsigned long refillInterval;
+  unsigned long lastRefill;
+
+public:
+  /**
+   * Create a full bucket
+   * @param burst Tokens available at once
+   * @param refillMs Time to earn back one token
+   */
+  BasicRateLimiter(uint16_t burst, unsigned long refillMs)
+    : capacity(burst), tokens(burst), refillInterval(refillMs), lastRefill(0) {}
+
+  /**
+   * Take a token if one is available
+   * Returns false when the caller must wait
+   */
+  bool tryAcquire(unsigned long now) {
+    refill(now);
+    if (tokens == 0) {
+      return false;
+    }
+    if (tokens == capacity) {
+      lastRefill = now;  // Refill clock starts with the first token spent
+    }
+    tokens--;
+    return true;
+  }
+
+  /**
+   * Take a token using the current time
+   */
+  bool tryAcquire() {
+    return tryAcquire(TimeSource::now());
+  }
+
+  /**
+   * Time until a token is available (0 if one is available now)
+   */
+  unsigned long timeUntilAvailable(unsigned long now) const {
+    if (tokens > 0 || refillInterval == 0) return 0;
+    unsigned long elapsed = now - lastRefill;
+    return elapsed >= refillInterval ? 0 : refillInterval - elapsed;
+  }
+
+  /**
+   * Tokens left, as of the last tryAcquire()
+   */
+  uint16_t getTokens() const {
+    return tokens;
+  }
+
+  /**
+   * Get the bucket size
+   */
+  uint16_t getCapacity() const {
+    return capacity;
+  }
+
+  /**
+   * Get the time to earn back one token
+   */
+  unsigned long getRefillInterval() const {
+    return refillInterval;
+  }
+
+  /**
+   * Refill the bucket completely
+   */
+  void reset() {
+    tokens = capacity;
+  }
+
+private:
+  /**
+   * Credit tokens earned since the last refill, keeping the remainder
+   */
+  void refill(unsigned long now) {
+    if (tokens >= capacity) {
+      return;
+    }
+    if (refillInterval == 0) {
+      tokens = capacity;
+      return;
+    }
+    unsigned long earned = (now - lastRefill) / refillInterval;
+    if (earned == 0) {
+      return;
+    }
+    if (earned >= (unsigned long)(capacity - tokens)) {
+      tokens = capacity;
+    } else {
+      tokens += earned;
+      lastRefill += earned * refillInterval;
+    }
+  }
+};
+
+typedef BasicRateLimiter<> RateLimiter;
+
+} // namespace MooreArduino
+
+#endif // MOORE_RATE_LIMITER_H
@@ -0,0 +1,302 @@
+#ifndef MOORE_RETRY_POLICY_H
+#define MOORE_RETRY_POLICY_H
+
+#include <Arduino.h>
+#include "Clock.h"
+
+namespace MooreArduino {
+
+/**
+ * Hash bytes (e.g. a MAC address) into a per-device seed
+ *
+ * FNV-1a: cheap, deterministic, and different for every device, so
+ * devices that fail together do not retry together.
+ */
+inline uint32_t deviceSeed(const uint8_t* bytes, uint8_t length) {
+  uint32_t hash = 2166136261UL;
+  for (uint8_t i = 0; i < length; i++) {
+    hash ^= bytes[i];
+    hash *= 16777619UL;
+  }
+  return hash != 0 ? hash : 1;  // xorshift must never be seeded with 0
+}
+
+/**
+ * Retry scheduling with exponential backoff and decorrelated jitter
+ *
+ * After each failure, schedule() picks the next delay as a random value
+ * between the base delay and three times the previous delay, capped at
+ * maxDelay ("decorrelated jitter"). Delays grow roughly exponentially,
+ * yet two devices that failed at the same instant quickly drift apart.
+ *
+ * For fleets, setInitialSpread() delays the first attempt after a reset()
+ * by a fixed per-device offset derived from the seed, so a building full
+ * of devices that lose the same access point at the same instant starts
+ * retrying spread over the whole window instead of in one burst.
+ *
+ * The policy never retries by itself: the input layer asks due(now) and
+ * turns a true answer into a retry input for the machine, so the retry
+ * shows up as an ordinary timestamped input.
+ *
+ * Usage:
+ *   RetryPolicy reconnect(2000, 60000, 10);  // 2s base, 60s cap, 10 attempts
+ *
+ *   void setup() {
+ *     reconnect.seed(deviceSeed(mac, 6));
+ *     reconnect.setInitialSpread(30000);  // First retry 0-30s after the failure
+ *   }
+ *
+ *   // On failure (e.g. from a state observer)
+ *   if (!reconnect.schedule(now)) {
+ *     // Out of attempts - wait for the user
+ *   }
+ *
+ *   // In the input layer
+ *   if (reconnect.due(now)) {
+ *     return stamp(Input::retryConnection(), now);
+ *   }
+ *
+ *   // On success
+ *   reconnect.reset();
+ */
+template<typename TimeSource = MillisTimeSource>
+class BasicRetryPolicy {
+private:
+  unsigned long baseDelay;
+  unsigned long maxDelay;
+  uint16_t maxAttempts;
+  uint16_t attempts;
+  unsigned long lastDelay;    // Backoff memory for the decorrelated jitter
+  unsigned long wait;         // Delay of the scheduled attempt (backoff + spread)
+  unsigned long scheduledAt;
+  unsigned long initialSpread;
+  unsigned long spreadOffset; // This device's share of initialSpread
+  bool pending;
+  uint32_t deviceHash;
+  uint32_t rng;
+
+public:
+  static const unsigned long DEFAULT_BASE_DELAY = 1000;  // ms
+  static const unsigned long DEFAULT_MAX_DELAY = 60000;  // ms
+  static const uint16_t UNLIMITED_ATTEMPTS = 0;
+
+  /**
+   * Create a retry policy
+   * @param baseMs Smallest delay between attempts
+   * @param maxMs Largest delay between attempts
+   * @param maxTries Attempts before giving up (UNLIMITED_ATTEMPTS = never)
+   */
+  BasicRetryPolicy(unsigned long baseMs = DEFAULT_BASE_DELAY,
+                   unsigned long maxMs = DEFAULT_MAX_DELAY,
+                   uint16_t maxTries = UNLIMITED_ATTEMPTS)
+    : baseDelay(baseMs), maxDelay(maxMs < baseMs ? baseMs : maxMs), maxAttempts(maxTries),
+      attempts(0), lastDelay(baseMs), wait(baseMs), scheduledAt(0), initialSpread(0),
+      spreadOffset(0), pending(false), deviceHash(0x9E3779B9UL), rng(0x9E3779B9UL) {}
+
+  /**
+   * Seed the jitter generator (use deviceSeed() so every device differs)
+   */
+  void seed(uint32_t value) {
+    rng = value != 0 ? value : 1;
+    deviceHash = rng;
+    updateSpreadOffset();
+  }
+
+  /**
+   * Delay the first attempt after a reset() by a per-device offset
+   * in [0, spreadMs), fixed by the seed (0 disables the spread)
+   */
+  void setInitialSpread(unsigned long spreadMs) {
+    initialSpread = spreadMs;
+    updateSpreadOffset();
+  }
+
+  /**
+   * Get the initial spread window
+   */
+  unsigned long getInitialSpread() const {
+    return initialSpread;
+  }
+
+  /**
+   * Schedule the next attempt after a failure
+   * Returns false (and schedules nothing) once maxAttempts is used up
+   */
+  bool schedule(unsigned long now) {
+    if (exhausted()) {
+      pending = false;
+      return false;
+    }
+
+    // Decorrelated jitter: uniform in [base, 3 × previous], capped
+    unsigned long upper = lastDelay > maxDelay / 3 ? maxDelay : lastDelay * 3;
+    if (upper < baseDelay) upper = baseDelay;  // Base raised since the last draw
+    lastDelay = baseDelay + random32() % (upper - baseDelay + 1);
+    wait = (attempts == 0) ? lastDelay + spreadOffset : lastDelay;
+
+    attempts++;
+    scheduledAt = now;
+    pending = true;
+    return true;
+  }
+
+  /**
+   * Schedule the next attempt from the current time
+   */
+  bool schedule() {
+    return schedule(TimeSource::now());
+  }
+
+  /**
+   * Return true once when the scheduled attempt is due
+   */
+  bool due(unsigned long now) {
+    if (!isDue(now)) {
+      return false;
+    }
+    pending = false;
+    return true;
+  }
+
+  /**
+   * Check if the scheduled attempt is due without consuming it
+   */
+  bool isDue(unsigned long now) const {
+    return pending && now - scheduledAt >= wait;
+  }
+
+  /**
+   * Check if the scheduled attempt is due using the current time
+   */
+  bool due() {
+    return due(TimeSource::now());
+  }
+
+  /**
+   * Forget the failure history after a success
+   */
+  void reset() {
+    attempts = 0;
+    lastDelay = baseDelay;
+    pending = false;
+  }
+
+  /**
+   * Drop the scheduled attempt but keep the failure history
+   */
+  void cancel() {
+    pending = false;
+  }
+
+  /**
+   * Check if an attempt is scheduled
+   */
+  bool isScheduled() const {
+    return pending;
+  }
+
+  /**
+   * Check if every allowed attempt has been scheduled
+   */
+  bool exhausted() const {
+    return maxAttempts != UNLIMITED_ATTEMPTS && attempts >= maxAttempts;
+  }
+
+  /**
+   * Time until the scheduled attempt is due (0 if due or none scheduled)
+   */
+  unsigned long remainingTime(unsigned long now) const {
+    if (!pending) return 0;
+    unsigned long elapsed = now - scheduledAt;
+    return elapsed >= wait ? 0 : wait - elapsed;
+  }
+
+  /**
+   * Time until the scheduled attempt is due (for TicklessIdle::until)
+   * Returns 0xFFFFFFFF when nothing is scheduled
+   */
+  unsigned long timeUntilDeadline(unsigned long now) const {
+    return pending ? remainingTime(now) : 0xFFFFFFFFUL;
+  }
+
+  /**
+   * Number of attempts scheduled since the last reset()
+   */
+  uint16_t getAttempts() const {
+    return attempts;
+  }
+
+  /**
+   * Delay chosen by the last schedule(), including any initial spread
+   */
+  unsigned long getLastDelay() const {
+    return wait;
+  }
+
+  /**
+   * Set the smallest delay between attempts
+   */
+  void setBaseDelay(unsigned long ms) {
+    baseDelay = ms;
+    if (maxDelay < baseDelay) maxDelay = baseDelay;
+  }
+
+  /**
+   * Set the largest delay between attempts
+   */
+  void setMaxDelay(unsigned long ms) {
+    maxDelay = ms < baseDelay ? baseDelay : ms;
+  }
+
+  /**
+   * Set attempts before giving up (UNLIMITED_ATTEMPTS = never)
+   */
+  void setMaxAttempts(uint16_t tries) {
+    maxAttempts = tries;
+  }
+
+  /**
+   * Get the base delay
+   */
+  unsigned long getBaseDelay() const {
+    return baseDelay;
+  }
+
+  /**
+   * Get the maximum delay
+   */
+  unsigned long getMaxDelay() const {
+    return maxDelay;
+  }
+
+  /**
+   * Get the attempt limit
+   */
+  uint16_t getMaxAttempts() const {
+    return maxAttempts;
+  }
+
+private:
+  /**
+   * Derive this device's fixed offset within the initial spread window
+   */
+  void updateSpreadOffset() {
+    spreadOffset = initialSpread > 0 ? deviceHash % initialSpread : 0;
+  }
+
+  /**
+   * xorshift32: tiny, fast, and good enough for jitter
+   */
+  uint32_t random32() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+  }
+};
+
+typedef BasicRetryPolicy<> RetryPolicy;
+
+} // namespace MooreArduino
+
+#endif // MOORE_RETRY_POLICY_H
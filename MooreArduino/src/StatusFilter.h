@@ -0,0 +1,173 @@
+#ifndef MOORE_STATUS_FILTER_H
+#define MOORE_STATUS_FILTER_H
+
+#include <Arduino.h>
+#include "Clock.h"
+
+namespace MooreArduino {
+
+/**
+ * Settle-time filter between a raw status reading and machine inputs
+ *
+ * Drivers report status codes that can flip for a moment and flip back
+ * (a WiFi link that drops for half a second). The filter only accepts a
+ * new status once the raw reading has differed from the current one for
+ * a settle time; shorter excursions are counted as suppressed flaps and
+ * never reach the machine.
+ *
+ * The settle time is asymmetric: changes to the "good" status (e.g.
+ * WL_CONNECTED) settle after `enterMs`, every other change after
+ * `leaveMs`. A short enterMs with a longer leaveMs reports a link coming
+ * up quickly but only believes it went away once it stays away.
+ *
+ * The current status is not kept here - the caller passes the value the
+ * machine last accepted, so the filter can never disagree with the state.
+ *
+ * Usage:
+ *   StatusFilter wifiFilter(WL_CONNECTED, 0, 3000);  // Up at once, down after 3s
+ *
+ *   int raw = WiFi.status();
+ *   if (wifiFilter.update(raw, state.wifiStatus, now)) {
+ *     return stamp(Input::wifiStatusChanged(raw), now);
+ *   }
+ */
+template<typename TimeSource = MillisTimeSource>
+class BasicStatusFilter {
+private:
+  int goodValue;
+  unsigned long enterDelay;
+  unsigned long leaveDelay;
+  unsigned long since;        // When the raw reading first differed
+  int candidate;              // Latest differing raw reading
+  bool pending;
+  unsigned long suppressed;
+  unsigned long accepted;
+
+public:
+  /**
+   * Create a filter
+   * @param good Status that settles after enterMs
+   * @param enterMs Settle time for changes to `good`
+   * @param leaveMs Settle time for every other change
+   */
+  BasicStatusFilter(int good, unsigned long enterMs, unsigned long leaveMs)
+    : goodValue(good), enterDelay(enterMs), leaveDelay(leaveMs), since(0),
+      candidate(good), pending(false), suppressed(0), accepted(0) {}
+
+  /**
+   * Feed one raw reading
+   * Returns true once the reading has differed from `current` for its
+   * settle time - the caller should then report `raw`
+   * @param raw Status just read from the driver
+   * @param current Status the machine currently holds
+   * @param now Time of the reading
+   */
+  bool update(int raw, int current, unsigned long now) {
+    if (raw == current) {
+      if (pending) {
+        pending = false;  // Back before it settled: a flap
+        suppressed++;
+      }
+      return false;
+    }
+
+    if (!pending) {
+      pending = true;
+      since = now;
+    }
+    candidate = raw;  // Settle time runs from the first difference
+
+    if (now - since < settleTime(raw)) {
+      return false;
+    }
+    pending = false;
+    accepted++;
+    return true;
+  }
+
+  /**
+   * Feed one raw reading taken at the current time
+   */
+  bool update(int raw, int current) {
+    return update(raw, current, TimeSource::now());
+  }
+
+  /**
+   * Check if a differing reading is waiting to settle
+   */
+  bool isSettling() const {
+    return pending;
+  }
+
+  /**
+   * Time until the waiting reading settles (0 if none is waiting)
+   */
+  unsigned long remainingTime(unsigned long now) const {
+    if (!pending) return 0;
+    unsigned long elapsed = now - since;
+    unsigned long settle = settleTime(candidate);
+    return elapsed >= settle ? 0 : settle - elapsed;
+  }
+
+  /**
+   * Time until the waiting reading settles (for TicklessIdle::until)
+   * Returns 0xFFFFFFFF when no reading is waiting
+   */
+  unsigned long timeUntilDeadline(unsigned long now) const {
+    return pending ? remainingTime(now) : 0xFFFFFFFFUL;
+  }
+
+  /**
+   * Forget a waiting reading without counting it
+   */
+  void reset() {
+    pending = false;
+  }
+
+  /**
+   * Number of changes that reverted before they settled
+   */
+  unsigned long getSuppressed() const {
+    return suppressed;
+  }
+
+  /**
+   * Number of changes that settled and were reported
+   */
+  unsigned long getAccepted() const {
+    return accepted;
+  }
+
+  /**
+   * Set the settle times
+   */
+  void setSettleTimes(unsigned long enterMs, unsigned long leaveMs) {
+    enterDelay = enterMs;
+    leaveDelay = leaveMs;
+  }
+
+  /**
+   * Get the settle time for changes to the good status
+   */
+  unsigned long getEnterTime() const {
+    return enterDelay;
+  }
+
+  /**
+   * Get the settle time for every other change
+   */
+  unsigned long getLeaveTime() const {
+    return leaveDelay;
+  }
+
+private:
+  unsigned long settleTime(int raw) const {
+    return raw == goodValue ? enterDelay : leaveDelay;
+  }
+};
+
+typedef BasicStatusFilter<> StatusFilter;
+
+} // namespace MooreArduino
+
+#endif // MOORE_STATUS_FILTER_H
@@ -0,0 +1,147 @@
+#ifndef MOORE_TICKLESS_IDLE_H
+#define MOORE_TICKLESS_IDLE_H
+
+#include <Arduino.h>
+#include "Clock.h"
+
+namespace MooreArduino {
+
+/**
+ * Tickless run loop: sleep until the next deadline instead of delay(10)
+ *
+ * Each loop iteration, offer every pending deadline (timers, async ops,
+ * timing wheels, blink edges) and then call sleep(). The CPU rests until
+ * the earliest of them, until maxSleep elapses, or until an interrupt
+ * handler calls wake() - whichever comes first. Reaction latency then
+ * depends on when events happen, not on a fixed polling period.
+ *
+ * until() takes any type with a `timeUntilDeadline(now)` method that
+ * returns a huge value when nothing is pending, so a new component only
+ * has to provide that method.
+ *
+ * maxSleep bounds the sleep for inputs that can only be polled (Serial,
+ * WiFi.status(), unbuffered buttons).
+ *
+ * Usage:
+ *   TicklessIdle idle(50);  // Poll Serial at least every 50 ms
+ *
+ *   void buttonISR() { idle.wake(); }
+ *
+ *   void loop() {
+ *     unsigned long now = clock.update();
+ *     // ... read inputs, step the machine, execute effects ...
+ *
+ *     idle.begin();
+ *     idle.until(heartbeat, now);
+ *     idle.until(wifiConnection, now);
+ *     idle.sleep(now);
+ *   }
+ */
+template<typename TimeSource = MillisTimeSource>
+class BasicTicklessIdle {
+public:
+  typedef typename TimeSource::time_type time_type;
+
+private:
+  unsigned long maxSleep;
+  unsigned long budget;           // Time left until the earliest offered deadline
+  unsigned long lastSleep;
+  volatile bool wakeRequested;
+
+public:
+  static const unsigned long DEFAULT_MAX_SLEEP = 1000; // ms
+
+  /**
+   * Create an idle helper that never sleeps longer than maxSleepMs
+   */
+  BasicTicklessIdle(unsigned long maxSleepMs = DEFAULT_MAX_SLEEP)
+    : maxSleep(maxSleepMs), budget(maxSleepMs), lastSleep(0), wakeRequested(false) {}
+
+  /**
+   * Start collecting deadlines for this loop iteration
+   */
+  void begin() {
+    budget = maxSleep;
+  }
+
+  /**
+   * Wake up no later than delayMs from now
+   */
+  void within(unsigned long delayMs) {
+    if (delayMs < budget) {
+      budget = delayMs;
+    }
+  }
+
+  /**
+   * Wake up at the next deadline of anything with a
+   * timeUntilDeadline(now) method: Timer, AsyncOp, TimerWheel,
+   * AsyncOpPool, RetryPolicy, LinkMonitor, StatusFilter, GestureDetector
+   */
+  template<typename Schedule>
+  void until(const Schedule& schedule, time_type now) {
+    offer(schedule.timeUntilDeadline(now));
+  }
+
+  /**
+   * Sleep until the earliest deadline or wake()
+   * @param now Time the deadlines were computed against
+   * @return Milliseconds actually slept
+   */
+  unsigned long sleep(time_type now) {
+    while (!wakeRequested) {
+      unsigned long elapsed = (unsigned long)(TimeSource::now() - now);
+      if (elapsed >= budget) break;
+      TimeSource::idle(budget - elapsed);
+    }
+    wakeRequested = false;
+    lastSleep = (unsigned long)(TimeSource::now() - now);
+    return lastSleep;
+  }
+
+  /**
+   * Cut the current or next sleep short (safe to call from an ISR)
+   */
+  void wake() {
+    wakeRequested = true;
+    TimeSource::wake();
+  }
+
+  /**
+   * Set the longest allowed sleep in milliseconds
+   */
+  void setMaxSleep(unsigned long ms) {
+    maxSleep = ms;
+  }
+
+  /**
+   * Get the longest allowed sleep
+   */
+  unsigned long getMaxSleep() const {
+    return maxSleep;
+  }
+
+  /**
+   * Get how long the last sleep() lasted
+   */
+  unsigned long getLastSleep() const {
+    return lastSleep;
+  }
+
+private:
+  /**
+   * within() for a duration that may not fit in unsigned long (64-bit sources)
+   */
+  template<typename Duration>
+  void offer(Duration delayMs) {
+    if (delayMs < budget) {
+      budget = (unsigned long)delayMs;
+    }
+  }
+};
+
+typedef BasicTicklessIdle<> TicklessIdle;
+
+} // namespace MooreArduino
+
+#endif // MOORE_TICKLESS_IDLE_H
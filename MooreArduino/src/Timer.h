@@ -2,9 +2,19 @@
 #define REDUX_TIMER_H
 
 #include <Arduino.h>
+#include "Clock.h"
 
 namespace MooreArduino {
 
+/**
+ * What a periodic Timer does with ticks it observed late
+ */
+enum TimerCatchUp {
+  CATCHUP_SKIP,    // Drop missed ticks, stay aligned to the original schedule
+  CATCHUP_BURST,   // Deliver every missed tick on consecutive expired() checks
+  CATCHUP_REPORT   // Drop missed ticks but count them (see getMissed())
+};
+
 /**
  * Simple non-blocking timer for Redux applications
  * 
@@ -16,25 +26,61 @@ namespace MooreArduino {
  *     // Do something every second
  *     heartbeat.restart();
  *   }
+ * 
+ * Every time-dependent method also takes an explicit `now` so a loop can
+ * share one Clock snapshot between all of its components.
+ * 
+ * The TimeSource parameter selects where "now" comes from (see Clock.h);
+ * `Timer` is the millis()-backed default. `LongTimer` runs on the 64-bit
+ * Millis64TimeSource for intervals beyond the 49.7 day millis() wrap.
+ * 
+ * Periodic mode:
+ *   By default restart() starts a new interval from "now", so every late
+ *   check pushes all later ticks back. After setPeriodic(), restart()
+ *   advances the deadline by exactly one interval instead, keeping the
+ *   long-term rate exact under load:
+ * 
+ *   Timer tick(100);
+ *   tick.setPeriodic(CATCHUP_REPORT);
+ *   tick.start(now);
+ *   if (tick.expired(now)) {
+ *     tick.restart(now);
+ *     unsigned long late = tick.takeMissed();  // Ticks dropped while busy
+ *   }
  */
-class Timer {
+template<typename TimeSource = MillisTimeSource>
+class BasicTimer {
+public:
+  typedef typename TimeSource::time_type time_type;
+
 private:
-  unsigned long interval;
-  unsigned long lastTrigger;
+  time_type interval;
+  time_type lastTrigger;
   bool running;
+  bool periodic;
+  TimerCatchUp catchUp;
+  unsigned long missed;
 
 public:
   /**
    * Create a timer with the specified interval in milliseconds
    */
-  Timer(unsigned long intervalMs) 
-    : interval(intervalMs), lastTrigger(0), running(false) {}
+  BasicTimer(time_type intervalMs) 
+    : interval(intervalMs), lastTrigger(0), running(false),
+      periodic(false), catchUp(CATCHUP_SKIP), missed(0) {}
 
   /**
    * Start the timer from now
    */
   void start() {
-    lastTrigger = millis();
+    start(TimeSource::now());
+  }
+
+  /**
+   * Start the timer from the given timestamp
+   */
+  void start(time_type now) {
+    lastTrigger = now;
     running = true;
   }
 
@@ -42,7 +88,14 @@ public:
    * Check if the timer has expired
    */
   bool expired() const {
-    return running && (millis() - lastTrigger >= interval);
+    return expired(TimeSource::now());
+  }
+
+  /**
+   * Check if the timer has expired at the given timestamp
+   */
+  bool expired(time_type now) const {
+    return running && !beforePeriod(now) && (now - lastTrigger >= interval);
   }
 
   /**
@@ -53,24 +106,93 @@ public:
   }
 
   /**
-   * Restart the timer (same as start)
+   * Restart the timer (same as start, or the next period in periodic mode)
    */
   void restart() {
-    start();
+    restart(TimeSource::now());
+  }
+
+  /**
+   * Restart the timer from the given timestamp
+   * In periodic mode the deadline advances by exactly one interval instead
+   */
+  void restart(time_type now) {
+    if (!periodic || !running) {
+      start(now);
+      return;
+    }
+
+    lastTrigger += interval;
+
+    // Deadlines already in the past were missed while the loop was busy.
+    // Restarted early, the new period starts after now: nothing was missed.
+    if (catchUp != CATCHUP_BURST && interval > 0 && !beforePeriod(now) &&
+        now - lastTrigger >= interval) {
+      time_type late = (now - lastTrigger) / interval;
+      lastTrigger += late * interval;
+      if (catchUp == CATCHUP_REPORT) {
+        missed += (unsigned long)late;
+      }
+    }
+  }
+
+  /**
+   * Switch to drift-free periodic mode
+   */
+  void setPeriodic(TimerCatchUp policy = CATCHUP_SKIP) {
+    periodic = true;
+    catchUp = policy;
+  }
+
+  /**
+   * Switch back to one-shot mode (restart() counts from now)
+   */
+  void setOneShot() {
+    periodic = false;
+  }
+
+  /**
+   * Check if the timer is in periodic mode
+   */
+  bool isPeriodic() const {
+    return periodic;
+  }
+
+  /**
+   * Get the number of ticks dropped so far (CATCHUP_REPORT only)
+   */
+  unsigned long getMissed() const {
+    return missed;
+  }
+
+  /**
+   * Get and clear the number of dropped ticks (CATCHUP_REPORT only)
+   */
+  unsigned long takeMissed() {
+    unsigned long count = missed;
+    missed = 0;
+    return count;
   }
 
   /**
    * Change the interval and restart
    */
-  void setInterval(unsigned long newIntervalMs) {
+  void setInterval(time_type newIntervalMs) {
+    setInterval(newIntervalMs, TimeSource::now());
+  }
+
+  /**
+   * Change the interval and restart from the given timestamp
+   */
+  void setInterval(time_type newIntervalMs, time_type now) {
     interval = newIntervalMs;
-    start();
+    start(now);
   }
 
   /**
    * Get the current interval
    */
-  unsigned long getInterval() const {
+  time_type getInterval() const {
     return interval;
   }
 
@@ -84,16 +206,45 @@ public:
   /**
    * Get remaining time until expiration (0 if expired or stopped)
    */
-  unsigned long remainingTime() const {
+  time_type remainingTime() const {
+    return remainingTime(TimeSource::now());
+  }
+
+  /**
+   * Get remaining time at the given timestamp
+   */
+  time_type remainingTime(time_type now) const {
     if (!running) return 0;
+    if (beforePeriod(now)) return interval + (lastTrigger - now);
     
-    unsigned long elapsed = millis() - lastTrigger;
+    time_type elapsed = now - lastTrigger;
     if (elapsed >= interval) return 0;
     
     return interval - elapsed;
   }
+
+  /**
+   * Time until the timer expires (for TicklessIdle::until)
+   * Returns the largest time_type value when the timer is stopped
+   */
+  time_type timeUntilDeadline(time_type now) const {
+    return running ? remainingTime(now) : ~(time_type)0;
+  }
+
+private:
+  /**
+   * Check if a periodic restart() before the deadline moved the start of
+   * the current period past now (by at most one interval)
+   */
+  bool beforePeriod(time_type now) const {
+    time_type ahead = lastTrigger - now;
+    return periodic && ahead != 0 && ahead <= interval;
+  }
 };
 
+typedef BasicTimer<> Timer;
+typedef BasicTimer<Millis64TimeSource> LongTimer;
+
 } // namespace MooreArduino
 
 #endif // REDUX_TIMER_H
\ No newline at end of file
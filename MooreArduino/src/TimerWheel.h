@@ -0,0 +1,434 @@
+#ifndef MOORE_TIMER_WHEEL_H
+#define MOORE_TIMER_WHEEL_H
+
+#include <Arduino.h>
+#include "Clock.h"
+#include "Handle.h"
+
+namespace MooreArduino {
+
+/**
+ * Hierarchical timing wheel for many one-shot timers
+ *
+ * Owns up to Capacity timer entries, each carrying a Payload (usually the
+ * machine's Input). Call advance() once per loop with the Clock snapshot,
+ * then drain expirations with pollExpired() and feed them to step().
+ *
+ * Entries live in 5 levels of 32 slots with 1 ms resolution at the bottom,
+ * covering ~9.3 hours directly; longer timeouts are re-cascaded. Insert and
+ * cancel are O(1), advance() skips empty stretches of the wheel, and
+ * nextDeadline() tells the loop how long it may sleep.
+ *
+ * Template parameters:
+ *   Payload - Value returned when the timer fires (e.g. your Input type)
+ *   Capacity - Maximum number of pending timers (at most 65534)
+ *   TimeSource - Where "now" comes from (see Clock.h)
+ *
+ * Usage:
+ *   TimerWheel<Input, 32> timers;
+ *
+ *   Handle h = timers.schedule(30000, Input::connectTimeout(), now);
+ *   timers.cancel(h);  // O(1), safe on stale handles
+ *
+ *   void loop() {
+ *     unsigned long now = clock.update();
+ *     timers.advance(now);
+ *
+ *     Input input;
+ *     while (timers.pollExpired(input)) {
+ *       machine.step(stamp(input, now), now);
+ *     }
+ *   }
+ */
+template<typename Payload, uint16_t Capacity, typename TimeSource = MillisTimeSource>
+class TimerWheel {
+public:
+  typedef typename TimeSource::time_type time_type;
+
+  static const uint8_t SLOT_BITS = 5;
+  static const uint8_t SLOTS = 1 << SLOT_BITS;  // Slots per level
+  static const uint8_t LEVELS = 5;
+
+private:
+  static const uint16_t NIL = 0xFFFF;
+  static const uint8_t SLOT_MASK = SLOTS - 1;
+  static const uint8_t LIST_READY = 0xFE;  // Entry expired, waiting for pollExpired()
+  static const uint8_t LIST_FREE = 0xFF;   // Entry unused
+  static const time_type SPAN = (time_type)1 << (SLOT_BITS * LEVELS);  // Ticks covered by the wheel
+  static const time_type HALF_RANGE = ~(time_type)0 >> 1;  // Larger differences are negative
+
+  struct Entry {
+    time_type deadline;
+    Payload payload;
+    uint16_t prev;
+    uint16_t next;
+    uint16_t generation;
+    uint8_t list;  // Slot number (level * SLOTS + slot), LIST_READY or LIST_FREE
+  };
+
+  Entry entries[Capacity];
+  uint16_t heads[LEVELS * SLOTS];
+  uint32_t occupied[LEVELS];  // Bit per non-empty slot
+  uint16_t freeHead;
+  uint16_t readyHead;
+  uint16_t readyTail;
+  uint16_t pendingCount;      // Entries still in the wheel (not ready)
+  uint16_t readyCount;
+  time_type current;          // Last tick processed by advance()
+
+public:
+  /**
+   * Create an empty wheel
+   */
+  TimerWheel() {
+    clear(0);
+  }
+
+  /**
+   * Drop all timers and restart the wheel at the given time
+   */
+  void clear(time_type now) {
+    for (uint16_t i = 0; i < Capacity; i++) {
+      entries[i].list = LIST_FREE;
+      entries[i].generation = 1;
+      entries[i].next = (i + 1 < Capacity) ? i + 1 : NIL;
+    }
+    for (int i = 0; i < LEVELS * SLOTS; i++) {
+      heads[i] = NIL;
+    }
+    for (int i = 0; i < LEVELS; i++) {
+      occupied[i] = 0;
+    }
+    freeHead = Capacity > 0 ? 0 : NIL;
+    readyHead = NIL;
+    readyTail = NIL;
+    pendingCount = 0;
+    readyCount = 0;
+    current = now;
+  }
+
+  /**
+   * Schedule payload to fire delayMs after now
+   * Returns an invalid Handle if the wheel is full
+   */
+  Handle schedule(time_type delayMs, const Payload& payload, time_type now) {
+    if (freeHead == NIL) {
+      return Handle();
+    }
+
+    // An idle wheel has nothing to catch up on - jump straight to now
+    if (pendingCount == 0) {
+      current = now;
+    }
+
+    uint16_t index = freeHead;
+    Entry& e = entries[index];
+    freeHead = e.next;
+    e.deadline = now + delayMs;
+    e.payload = payload;
+    insert(index);
+    return Handle(index, e.generation);
+  }
+
+  /**
+   * Schedule payload to fire delayMs from the current time
+   */
+  Handle schedule(time_type delayMs, const Payload& payload) {
+    return schedule(delayMs, payload, TimeSource::now());
+  }
+
+  /**
+   * Cancel a pending timer
+   * Returns false if the handle is stale (already fired or cancelled)
+   */
+  bool cancel(const Handle& handle) {
+    if (!isPending(handle)) {
+      return false;
+    }
+    unlink(handle.index);
+    release(handle.index);
+    return true;
+  }
+
+  /**
+   * Check if a timer is still waiting to fire or to be polled
+   */
+  bool isPending(const Handle& handle) const {
+    return handle.index < Capacity &&
+           entries[handle.index].generation == handle.generation &&
+           entries[handle.index].list != LIST_FREE;
+  }
+
+  /**
+   * Process every tick up to and including now
+   * Expired timers are queued for pollExpired() in deadline order
+   */
+  void advance(time_type now) {
+    while (after(now, current)) {
+      if (pendingCount == 0) {
+        current = now;
+        return;
+      }
+
+      // Skip to the end of the block covered by the empty lower levels
+      time_type skipMask = 0;
+      for (uint8_t level = 0; level < LEVELS && occupied[level] == 0; level++) {
+        skipMask = (skipMask << SLOT_BITS) | SLOT_MASK;
+      }
+      if (skipMask != 0 && (current & skipMask) != skipMask) {
+        time_type target = current | skipMask;
+        if (!after(now, target)) {
+          current = now;
+          return;
+        }
+        current = target;
+        continue;
+      }
+
+      current++;
+      cascade();
+      expireSlot(current & SLOT_MASK);
+    }
+  }
+
+  /**
+   * Advance the wheel to the current time
+   */
+  void advance() {
+    advance(TimeSource::now());
+  }
+
+  /**
+   * Pop the next expired timer's payload
+   * Returns false when nothing has expired
+   */
+  bool pollExpired(Payload& out) {
+    if (readyHead == NIL) {
+      return false;
+    }
+    uint16_t index = readyHead;
+    out = entries[index].payload;
+    unlink(index);
+    release(index);
+    return true;
+  }
+
+  /**
+   * Get the earliest pending deadline
+   * Returns false if no timers are pending
+   */
+  bool nextDeadline(time_type& deadline) const {
+    if (readyHead != NIL) {
+      deadline = current;  // Already due
+      return true;
+    }
+
+    bool found = false;
+    time_type best = 0;
+    for (uint8_t level = 0; level < LEVELS; level++) {
+      if (occupied[level] == 0) continue;
+
+      // Walk slots in firing order, starting just after the current one
+      uint8_t base = (current >> (SLOT_BITS * level)) & SLOT_MASK;
+      for (uint8_t step = 1; step <= SLOTS; step++) {
+        uint8_t slot = (base + step) & SLOT_MASK;
+        if (!(occupied[level] & (1UL << slot))) continue;
+
+        for (uint16_t i = heads[level * SLOTS + slot]; i != NIL; i = entries[i].next) {
+          time_type d = entries[i].deadline;
+          if (!found || d - current < best - current) {
+            best = d;
+            found = true;
+          }
+        }
+        break;
+      }
+    }
+
+    if (found) {
+      deadline = best;
+    }
+    return found;
+  }
+
+  /**
+   * Time until the earliest timer fires (for TicklessIdle::until)
+   * Returns the largest time_type value when no timers are pending
+   */
+  time_type timeUntilDeadline(time_type now) const {
+    time_type deadline;
+    if (!nextDeadline(deadline)) return ~(time_type)0;
+    return after(deadline, now) ? deadline - now : 0;
+  }
+
+  /**
+   * Number of timers pending or waiting to be polled
+   */
+  uint16_t size() const {
+    return pendingCount + readyCount;
+  }
+
+  /**
+   * Check if no timers are pending
+   */
+  bool isEmpty() const {
+    return size() == 0;
+  }
+
+  /**
+   * Maximum number of timers
+   */
+  uint16_t getCapacity() const {
+    return Capacity;
+  }
+
+private:
+  /**
+   * Wrap-safe "a is later than b" (for any width of time_type)
+   */
+  static bool after(time_type a, time_type b) {
+    time_type delta = a - b;
+    return delta != 0 && delta <= HALF_RANGE;
+  }
+
+  /**
+   * Place an entry in the slot matching its distance from current
+   */
+  void insert(uint16_t index) {
+    Entry& e = entries[index];
+    time_type delta = e.deadline - current;
+
+    if (delta == 0 || delta > HALF_RANGE) {
+      pushReady(index);  // Deadline already reached
+      return;
+    }
+
+    uint8_t level = 0;
+    while (level < LEVELS - 1 && delta >= (1UL << (SLOT_BITS * (level + 1)))) {
+      level++;
+    }
+
+    // Beyond the wheel's span: park in the farthest slot and re-cascade later
+    time_type position = (delta >= SPAN) ? current + SPAN - 1 : e.deadline;
+    uint8_t slot = (position >> (SLOT_BITS * level)) & SLOT_MASK;
+    uint8_t list = level * SLOTS + slot;
+
+    e.list = list;
+    e.prev = NIL;
+    e.next = heads[list];
+    if (e.next != NIL) {
+      entries[e.next].prev = index;
+    }
+    heads[list] = index;
+    occupied[level] |= (1UL << slot);
+    pendingCount++;
+  }
+
+  /**
+   * Append an entry to the ready queue
+   */
+  void pushReady(uint16_t index) {
+    Entry& e = entries[index];
+    e.list = LIST_READY;
+    e.next = NIL;
+    e.prev = readyTail;
+    if (readyTail != NIL) {
+      entries[readyTail].next = index;
+    } else {
+      readyHead = index;
+    }
+    readyTail = index;
+    readyCount++;
+  }
+
+  /**
+   * Remove an entry from whichever list holds it
+   */
+  void unlink(uint16_t index) {
+    Entry& e = entries[index];
+
+    if (e.prev != NIL) {
+      entries[e.prev].next = e.next;
+    }
+    if (e.next != NIL) {
+      entries[e.next].prev = e.prev;
+    }
+
+    if (e.list == LIST_READY) {
+      if (readyHead == index) readyHead = e.next;
+      if (readyTail == index) readyTail = e.prev;
+      readyCount--;
+    } else {
+      if (heads[e.list] == index) {
+        heads[e.list] = e.next;
+      }
+      if (heads[e.list] == NIL) {
+        occupied[e.list / SLOTS] &= ~(1UL << (e.list & SLOT_MASK));
+      }
+      pendingCount--;
+    }
+  }
+
+  /**
+   * Return an entry to the free list and invalidate its handles
+   */
+  void release(uint16_t index) {
+    Entry& e = entries[index];
+    e.list = LIST_FREE;
+    e.generation++;
+    if (e.generation == 0) e.generation = 1;
+    e.next = freeHead;
+    freeHead = index;
+  }
+
+  /**
+   * Detach a whole slot list, returning its head
+   */
+  uint16_t takeSlot(uint8_t level, uint8_t slot) {
+    uint8_t list = level * SLOTS + slot;
+    uint16_t head = heads[list];
+    heads[list] = NIL;
+    occupied[level] &= ~(1UL << slot);
+    for (uint16_t i = head; i != NIL; i = entries[i].next) {
+      pendingCount--;
+    }
+    return head;
+  }
+
+  /**
+   * Move entries from higher levels down when their block begins
+   */
+  void cascade() {
+    // Find the highest level whose lower digits all rolled over to zero
+    uint8_t top = 0;
+    while (top < LEVELS - 1 && (current & ((1UL << (SLOT_BITS * (top + 1))) - 1)) == 0) {
+      top++;
+    }
+
+    for (uint8_t level = top; level >= 1; level--) {
+      uint8_t slot = (current >> (SLOT_BITS * level)) & SLOT_MASK;
+      uint16_t i = takeSlot(level, slot);
+      while (i != NIL) {
+        uint16_t next = entries[i].next;
+        insert(i);
+        i = next;
+      }
+    }
+  }
+
+  /**
+   * Queue every entry in a bottom-level slot as expired
+   */
+  void expireSlot(uint8_t slot) {
+    uint16_t i = takeSlot(0, slot);
+    while (i != NIL) {
+      uint16_t next = entries[i].next;
+      pushReady(i);
+      i = next;
+    }
+  }
+};
+
+} // namespace MooreArduino
+
+#endif // MOORE_TIMER_WHEEL_H
@@ -0,0 +1,417 @@
+#ifndef MOORE_TRACE_BUFFER_H
+#define MOORE_TRACE_BUFFER_H
+
+#include <Arduino.h>
+
+namespace MooreArduino {
+
+/**
+ * One variable-length record of a TraceBuffer
+ *
+ * The application writes an input's fields with the put*() methods and
+ * reads them back in the same order with the matching get*() methods.
+ * Integers are stored as varints (7 bits per byte), so small values such
+ * as time deltas take a single byte; signed values are zigzag-encoded
+ * first so that small negative numbers stay small too.
+ *
+ * Writing past MAX_LENGTH or reading past the end marks the record
+ * invalid instead of touching memory outside it.
+ *
+ * Usage:
+ *   TraceRecord record;
+ *   record.putByte(input.type);
+ *   record.putVarint(input.timestamp - lastTimestamp);
+ *   record.putSigned(input.rssi);
+ *
+ *   uint8_t type = record.getByte();
+ *   uint32_t delta = record.getVarint();
+ *   int32_t rssi = record.getSigned();
+ */
+class TraceRecord {
+public:
+  static const uint8_t MAX_LENGTH = 96;  // Bytes per record
+
+private:
+  uint8_t bytes[MAX_LENGTH];
+  uint8_t length;
+  uint8_t position;  // Next byte read by get*()
+  bool valid;
+
+public:
+  /**
+   * Create an empty record
+   */
+  TraceRecord() : length(0), position(0), valid(true) {}
+
+  /**
+   * Empty the record for writing
+   */
+  void clear() {
+    length = 0;
+    position = 0;
+    valid = true;
+  }
+
+  /**
+   * Start reading from the first byte again
+   */
+  void rewind() {
+    position = 0;
+  }
+
+  /**
+   * Append one byte
+   */
+  void putByte(uint8_t value) {
+    if (length >= MAX_LENGTH) {
+      valid = false;
+      return;
+    }
+    bytes[length++] = value;
+  }
+
+  /**
+   * Append an unsigned integer as a varint (1-5 bytes)
+   */
+  void putVarint(uint32_t value) {
+    while (value >= 0x80) {
+      putByte((uint8_t)(value | 0x80));
+      value >>= 7;
+    }
+    putByte((uint8_t)value);
+  }
+
+  /**
+   * Append a signed integer as a zigzag varint (-64..63 take one byte)
+   */
+  void putSigned(int32_t value) {
+    putVarint(((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+  }
+
+  /**
+   * Append a string as its length followed by its characters
+   * @param maxLength Longest string stored; longer ones are cut
+   */
+  void putString(const char* text, uint8_t maxLength) {
+    uint8_t n = 0;
+    while (n < maxLength && text[n] != '\0') n++;
+    putByte(n);
+    for (uint8_t i = 0; i < n; i++) {
+      putByte((uint8_t)text[i]);
+    }
+  }
+
+  /**
+   * Read one byte (0 past the end)
+   */
+  uint8_t getByte() {
+    if (position >= length) {
+      valid = false;
+      return 0;
+    }
+    return bytes[position++];
+  }
+
+  /**
+   * Read a varint written by putVarint()
+   */
+  uint32_t getVarint() {
+    uint32_t value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+      uint8_t b = getByte();
+      value |= (uint32_t)(b & 0x7F) << shift;
+      if (!(b & 0x80)) break;
+    }
+    return value;
+  }
+
+  /**
+   * Read a zigzag varint written by putSigned()
+   */
+  int32_t getSigned() {
+    uint32_t value = getVarint();
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+  }
+
+  /**
+   * Read a string written by putString() into a buffer of `size` bytes
+   * The result is always null-terminated
+   */
+  void getString(char* text, size_t size) {
+    uint8_t n = getByte();
+    for (uint8_t i = 0; i < n; i++) {
+      char c = (char)getByte();
+      if ((size_t)i + 1 < size) text[i] = c;
+    }
+    if (size > 0) text[n < size ? n : size - 1] = '\0';
+  }
+
+  /**
+   * Check that nothing was written past MAX_LENGTH or read past the end
+   */
+  bool isValid() const {
+    return valid;
+  }
+
+  /**
+   * Number of bytes in the record
+   */
+  uint8_t size() const {
+    return length;
+  }
+
+  /**
+   * The record's bytes
+   */
+  const uint8_t* data() const {
+    return bytes;
+  }
+
+  /**
+   * Replace the contents with raw bytes (used by TraceBuffer)
+   */
+  void assign(const uint8_t* source, uint8_t count) {
+    clear();
+    for (uint8_t i = 0; i < count; i++) {
+      putByte(source[i]);
+    }
+  }
+};
+
+/**
+ * Fixed-size byte buffer of TraceRecords for compact input recording
+ *
+ * Storing whole Input structs wastes memory when most fields are unused
+ * for most inputs. Instead the application encodes each input into a
+ * TraceRecord - typically a type byte, a varint time delta and only the
+ * fields that differ from their defaults - and appends it here. Each
+ * record costs one length byte on top of its contents.
+ *
+ * With run-length encoding enabled, a record identical to the previous
+ * one (e.g. a periodic tick with the same delta) is not stored again;
+ * a 2-byte marker counts up to 255 repeats instead.
+ *
+ * Like InputTrace, the buffer keeps the beginning of the run: once a
+ * record does not fit, it and every later record are counted as dropped,
+ * so a replay never skips an input in the middle. data()/size() expose
+ * the raw bytes for printing or saving; appendRaw() loads them again.
+ *
+ * Usage:
+ *   TraceBuffer<4096> trace;
+ *
+ *   TraceRecord record;
+ *   record.putByte(input.type);
+ *   record.putVarint(input.timestamp - lastTimestamp);
+ *   trace.append(record);
+ *
+ *   trace.rewind();
+ *   while (trace.next(record)) {
+ *     uint8_t type = record.getByte();
+ *     // ...
+ *   }
+ *
+ * Template parameters:
+ *   Capacity - Buffer size in bytes
+ */
+template<uint16_t Capacity>
+class TraceBuffer {
+  static_assert(Capacity >= 2, "TraceBuffer needs room for at least one record");
+
+private:
+  static const uint8_t REPEAT_MARKER = 0;   // Length byte 0: repeat the previous record
+  static const uint16_t NONE = 0xFFFF;
+
+  uint8_t bytes[Capacity];
+  uint16_t length;
+  bool runLength;
+  bool full;                // A record was dropped - drop all later ones too
+  unsigned long records;    // Records appended, repeats included
+  unsigned long dropped;
+
+  // Writing: where the last record and its repeat marker are
+  uint16_t lastRecord;
+  uint16_t repeatAt;
+
+  // Reading
+  uint16_t cursor;
+  uint8_t repeatsLeft;
+  TraceRecord previous;
+
+public:
+  /**
+   * Create an empty buffer
+   * @param runLengthEncoding Store identical consecutive records once with a repeat count
+   */
+  TraceBuffer(bool runLengthEncoding = true)
+    : length(0), runLength(runLengthEncoding), full(false), records(0), dropped(0),
+      lastRecord(NONE), repeatAt(NONE), cursor(0), repeatsLeft(0) {}
+
+  /**
+   * Append one record
+   * Returns false (and counts it as dropped) if it does not fit, was
+   * invalid, or an earlier record was dropped
+   */
+  bool append(const TraceRecord& record) {
+    if (full || !record.isValid() || record.size() == 0) {
+      full = true;  // Records after a gap would replay from the wrong state
+      dropped++;
+      return false;
+    }
+
+    if (runLength && isRepeat(record)) {
+      if (repeatAt != NONE && bytes[repeatAt + 1] < 0xFF) {
+        bytes[repeatAt + 1]++;
+        records++;
+        return true;
+      }
+      if (repeatAt == NONE && length + 2 <= Capacity) {
+        repeatAt = length;
+        bytes[length++] = REPEAT_MARKER;
+        bytes[length++] = 1;
+        records++;
+        return true;
+      }
+      // Run is at 255: store the record again and start a new run after it
+    }
+
+    if (length + 1 + record.size() > Capacity) {
+      full = true;
+      dropped++;
+      return false;
+    }
+    lastRecord = length;
+    repeatAt = NONE;
+    bytes[length++] = record.size();
+    memcpy(bytes + length, record.data(), record.size());
+    length += record.size();
+    records++;
+    return true;
+  }
+
+  /**
+   * Read the next record, oldest first, ready for its get*() methods
+   * Returns false once every record has been read
+   */
+  bool next(TraceRecord& record) {
+    if (repeatsLeft > 0) {
+      repeatsLeft--;
+      record = previous;
+      record.rewind();
+      return true;
+    }
+    if (cursor >= length) {
+      return false;
+    }
+
+    uint8_t count = bytes[cursor];
+    if (count == REPEAT_MARKER) {
+      if (cursor + 2 > length || previous.size() == 0) {
+        cursor = length;  // Damaged data - stop
+        return false;
+      }
+      repeatsLeft = bytes[cursor + 1];
+      cursor += 2;
+      return next(record);
+    }
+    if (cursor + 1 + count > length || count > TraceRecord::MAX_LENGTH) {
+      cursor = length;
+      return false;
+    }
+    previous.assign(bytes + cursor + 1, count);
+    cursor += 1 + count;
+    record = previous;
+    return true;
+  }
+
+  /**
+   * Start reading from the first record again
+   */
+  void rewind() {
+    cursor = 0;
+    repeatsLeft = 0;
+    previous.clear();
+  }
+
+  /**
+   * Drop all records and counters
+   */
+  void clear() {
+    length = 0;
+    full = false;
+    records = 0;
+    dropped = 0;
+    lastRecord = NONE;
+    repeatAt = NONE;
+    rewind();
+  }
+
+  /**
+   * Append raw bytes taken from data() of another buffer (e.g. a dump)
+   * Returns false if they do not fit
+   */
+  bool appendRaw(const uint8_t* source, uint16_t count) {
+    if (length + count > Capacity) {
+      return false;
+    }
+    memcpy(bytes + length, source, count);
+    length += count;
+    lastRecord = NONE;  // Never extend a run across loaded data
+    repeatAt = NONE;
+    return true;
+  }
+
+  /**
+   * Number of bytes used
+   */
+  uint16_t size() const {
+    return length;
+  }
+
+  /**
+   * Buffer size in bytes
+   */
+  uint16_t getCapacity() const {
+    return Capacity;
+  }
+
+  /**
+   * The encoded bytes
+   */
+  const uint8_t* data() const {
+    return bytes;
+  }
+
+  /**
+   * Number of records appended, repeats included
+   */
+  unsigned long getRecords() const {
+    return records;
+  }
+
+  /**
+   * Number of records that were not stored
+   * A replay only reproduces the run up to the first dropped record
+   */
+  unsigned long getDropped() const {
+    return dropped;
+  }
+
+  /**
+   * Check if records are being dropped
+   */
+  bool isFull() const {
+    return full;
+  }
+
+private:
+  bool isRepeat(const TraceRecord& record) const {
+    if (lastRecord == NONE || bytes[lastRecord] != record.size()) {
+      return false;
+    }
+    return memcmp(bytes + lastRecord + 1, record.data(), record.size()) == 0;
+  }
+};
+
+} // namespace MooreArduino
+
+#endif // MOORE_TRACE_BUFFER_H
@@ -0,0 +1,193 @@
+/*
+ * FleetReconnect - Thundering-herd simulation for reconnect scheduling
+ *
+ * When an access point reboots, every device in range loses it at the
+ * same instant. If they all retry on the same schedule, the AP comes back
+ * to a burst of association attempts it cannot serve, most of them fail,
+ * and the failed devices retry together again.
+ *
+ * This sketch simulates a fleet of devices on VirtualTimeSource (no real
+ * waiting, no WiFi hardware) and compares three reconnect strategies:
+ *
+ *   fixed    - retry every 5 s, identical on every device
+ *   backoff  - RetryPolicy: exponential backoff with per-device jitter
+ *   fleet    - backoff + initial spread from the MAC + RateLimiter
+ *              (the configuration used by examples/WiFiManager)
+ *
+ * For each strategy it prints the peak number of association attempts
+ * the AP saw in any one second, the total number of attempts, and how
+ * long it took until every device was back online.
+ *
+ * Runs once in setup(); open the serial monitor at 115200 baud.
+ * Lower FLEET_SIZE on boards with little RAM.
+ */
+
+#include <MooreArduino.h>
+using namespace MooreArduino;
+
+//----------------------------------------------------------------------------//
+// Simulation Parameters
+//----------------------------------------------------------------------------//
+
+const uint16_t FLEET_SIZE = 200;                // Simulated devices
+const unsigned long AP_DOWN_MS = 20000;         // AP reboot takes 20 s
+const uint16_t AP_ASSOCIATIONS_PER_SEC = 20;    // AP serves this many associations per second
+const unsigned long SIM_STEP_MS = 10;           // Simulation resolution
+const unsigned long SIM_DURATION_MS = 600000;   // Give up after 10 minutes
+
+// Same values as the WiFiManager example
+const unsigned long RECONNECT_BASE_MS = 2000;
+const unsigned long RECONNECT_MAX_MS = 120000;
+const unsigned long RECONNECT_SPREAD_MS = 30000;
+const uint16_t CONNECT_BURST = 3;
+const unsigned long CONNECT_REFILL_MS = 30000;
+
+typedef BasicRetryPolicy<VirtualTimeSource> SimRetry;
+typedef BasicRateLimiter<VirtualTimeSource> SimRateLimiter;
+
+enum Strategy {
+  STRATEGY_FIXED,
+  STRATEGY_BACKOFF,
+  STRATEGY_FLEET
+};
+
+struct Device {
+  SimRetry retry;
+  SimRateLimiter limit;
+  bool online;
+
+  Device() : retry(RECONNECT_BASE_MS, RECONNECT_MAX_MS), limit(CONNECT_BURST, CONNECT_REFILL_MS),
+             online(true) {}
+};
+
+struct Report {
+  uint16_t peakPerSecond;
+  unsigned long peakAt;
+  unsigned long attempts;
+  unsigned long allOnlineAt;
+  bool allOnline;
+};
+
+Device fleet[FLEET_SIZE];
+
+//----------------------------------------------------------------------------//
+// Simulation
+//----------------------------------------------------------------------------//
+
+void configure(Device& device, uint16_t index, Strategy strategy) {
+  // Locally administered MAC, unique per simulated device
+  uint8_t mac[6] = {0x02, 0x00, 0x5E, 0x10, (uint8_t)(index >> 8), (uint8_t)index};
+
+  device = Device();
+  if (strategy == STRATEGY_FIXED) {
+    device.retry = SimRetry(5000, 5000);  // base == cap: no jitter, no growth
+    return;
+  }
+  device.retry.seed(deviceSeed(mac, sizeof(mac)));
+  if (strategy == STRATEGY_FLEET) {
+    device.retry.setInitialSpread(RECONNECT_SPREAD_MS);
+  }
+}
+
+Report simulate(Strategy strategy) {
+  Report report = {0, 0, 0, 0, false};
+
+  // t = 0: the AP reboots and every device drops off at once
+  VirtualTimeSource::set(0);
+  for (uint16_t i = 0; i < FLEET_SIZE; i++) {
+    configure(fleet[i], i, strategy);
+    fleet[i].online = false;
+    fleet[i].retry.schedule(0);
+  }
+
+  uint16_t offline = FLEET_SIZE;
+  unsigned long second = 0;
+  uint16_t attemptsThisSecond = 0;
+  uint16_t servedThisSecond = 0;
+
+  for (unsigned long now = 0; now < SIM_DURATION_MS && offline > 0; now += SIM_STEP_MS) {
+    VirtualTimeSource::set(now);
+
+    if (now / 1000 != second) {
+      second = now / 1000;
+      attemptsThisSecond = 0;
+      servedThisSecond = 0;
+    }
+
+    bool apUp = now >= AP_DOWN_MS;
+
+    for (uint16_t i = 0; i < FLEET_SIZE; i++) {
+      Device& device = fleet[i];
+      if (device.online || !device.retry.isDue(now)) continue;
+      if (strategy == STRATEGY_FLEET && !device.limit.tryAcquire(now)) continue;
+      device.retry.due(now);
+
+      // One association attempt hits the AP
+      report.attempts++;
+      attemptsThisSecond++;
+      if (attemptsThisSecond > report.peakPerSecond) {
+        report.peakPerSecond = attemptsThisSecond;
+        report.peakAt = second;
+      }
+
+      if (apUp && servedThisSecond < AP_ASSOCIATIONS_PER_SEC) {
+        servedThisSecond++;
+        device.online = true;
+        device.retry.reset();
+        offline--;
+      } else {
+        device.retry.schedule(now);  // AP down or overloaded: back off
+      }
+    }
+
+    if (offline == 0) {
+      report.allOnline = true;
+      report.allOnlineAt = now;
+    }
+  }
+
+  return report;
+}
+
+void printReport(const char* name, const Report& report) {
+  Serial.print(name);
+  Serial.print("peak ");
+  Serial.print(report.peakPerSecond);
+  Serial.print(" attempts/s (at ");
+  Serial.print(report.peakAt);
+  Serial.print(" s), ");
+  Serial.print(report.attempts);
+  Serial.print(" attempts total, ");
+  if (report.allOnline) {
+    Serial.print("all online after ");
+    Serial.print(report.allOnlineAt / 1000.0, 1);
+    Serial.println(" s");
+  } else {
+    Serial.println("not all online");
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Arduino Entry Points
+//----------------------------------------------------------------------------//
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print("Simulating ");
+  Serial.print(FLEET_SIZE);
+  Serial.print(" devices, AP down for ");
+  Serial.print(AP_DOWN_MS / 1000);
+  Serial.print(" s, AP serves ");
+  Serial.print(AP_ASSOCIATIONS_PER_SEC);
+  Serial.println(" associations/s");
+
+  printReport("fixed:   ", simulate(STRATEGY_FIXED));
+  printReport("backoff: ", simulate(STRATEGY_BACKOFF));
+  printReport("fleet:   ", simulate(STRATEGY_FLEET));
+}
+
+void loop() {
+  // Nothing to do - the simulation runs once in setup()
+}
@@ -119,6 +119,12 @@ MooreMachine<BlinkState, Input, Output> machine(transitionFunction, LED_OFF);
 // Timer for generating tick inputs
 Timer tickTimer(1000); // 1 second
 
+// One time snapshot per loop iteration
+Clock loopClock;
+
+// Sleeps until the next tick instead of polling
+TicklessIdle idle;
+
 void setup() {
   Serial.begin(115200);
   pinMode(LED_PIN, OUTPUT);
@@ -126,17 +132,20 @@ void setup() {
   // Set output function
   machine.setOutputFunction(outputFunction);
   
-  // Start timer
-  tickTimer.start();
+  // Start timer (periodic: no drift from late checks)
+  tickTimer.setPeriodic();
+  tickTimer.start(loopClock.update());
   
   Serial.println("SimpleBlink Moore Machine Started");
   Serial.println("LED should blink every second");
 }
 
 void loop() {
+  unsigned long now = loopClock.update();
+  
   // Generate tick input when timer expires
-  if (tickTimer.expired()) {
-    tickTimer.restart();
+  if (tickTimer.expired(now)) {
+    tickTimer.restart(now);
     machine.step(Input::tick());
   }
   
@@ -144,5 +153,8 @@ void loop() {
   Output currentOutput = machine.getCurrentOutput();
   executeOutput(currentOutput);
   
-  delay(10); // Small delay to prevent overwhelming
+  // Nothing else to do until the timer expires
+  idle.begin();
+  idle.until(tickTimer, now);
+  idle.sleep(now);
 }
@@ -61,8 +61,9 @@ struct AppState {
 
 struct Input {
   InputType type;
+  unsigned long timestamp;  // Capture time, so δ never reads the clock
   
-  Input() : type(INPUT_NONE) {}
+  Input() : type(INPUT_NONE), timestamp(0) {}
   
   static Input buttonPressed() {
     Input i;
@@ -143,7 +144,7 @@ const int BUTTON_PIN = 2;  // Button with pull-up
 
 AppState transitionFunction(const AppState& state, const Input& input) {
   AppState newState = state;
-  newState.lastUpdate = millis();
+  newState.lastUpdate = input.timestamp;
   
   switch (input.type) {
     case INPUT_BUTTON_PRESSED:
@@ -258,8 +259,10 @@ void observeModeChanges(const AppState& oldState, const AppState& newState) {
 //----------------------------------------------------------------------------//
 
 MooreMachine<AppState, Input, Output> machine(transitionFunction, AppState());
+Clock loopClock;             // One time snapshot per loop iteration
 Timer tickTimer(100);        // 10Hz tick rate
 Button ledButton(BUTTON_PIN); // Button on pin 2
+TicklessIdle idle(10);       // Wake at least every 10ms to sample the button
 
 //----------------------------------------------------------------------------//
 // Setup & Loop
@@ -280,13 +283,17 @@ void setup() {
   machine.addStateObserver(observeModeChanges);
   machine.setOutputFunction(outputFunction);
   
-  // Start tick timer
-  tickTimer.start();
+  // Start tick timer (periodic: blink cadence stays exact under load)
+  tickTimer.setPeriodic();
+  tickTimer.start(loopClock.update());
   
   Serial.println("Ready! Current mode: OFF");
 }
 
 void loop() {
+  // 0. Capture the time once for this iteration
+  unsigned long now = loopClock.update();
+  
   // 1. Get current effect from Moore machine λ: Q → Γ
   Output effect = machine.getCurrentOutput();
   
@@ -296,17 +303,20 @@ void loop() {
   // 3. Gather inputs from environment
   Input input = Input::none();
   
-  if (ledButton.wasPressed()) {
+  if (ledButton.wasPressed(now)) {
     input = Input::buttonPressed();
-  } else if (tickTimer.expired()) {
-    tickTimer.restart();
+  } else if (tickTimer.expired(now)) {
+    tickTimer.restart(now);
     input = Input::tick();
   }
   
   // 4. Step the machine with new input δ: Q × Σ → Q
   if (input.type != INPUT_NONE) {
-    machine.step(input);
+    machine.step(stamp(input, now), now);
   }
   
-  delay(10); // Small delay to prevent overwhelming the system
+  // 5. Sleep until the next tick (or the button sampling interval)
+  idle.begin();
+  idle.until(tickTimer, now);
+  idle.sleep(now);
 }
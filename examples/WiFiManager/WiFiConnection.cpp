@@ -1,6 +1,10 @@
 #include "WiFiConnection.h"
 #include "WiFiCredentials.h"
 #include "WiFiUI.h"
+#include "WiFiMetrics.h"
+#include "WiFiLease.h"
+#include "WiFiProbe.h"
+#include "WiFiTrace.h"
 #include <WiFi.h>
 #include <MooreArduino.h>
 
@@ -11,15 +15,54 @@ using namespace MooreArduino;
 //----------------------------------------------------------------------------//
 
 // Global utilities  
-extern Timer g_tickTimer;       // Defined in main file  
-extern Button g_resetButton;    // Defined in main file
+extern AppClock g_clock;        // Defined in main file
+extern AppTimer g_tickTimer;    // Defined in main file  
+extern AppTimer g_statusPoll;   // Defined in main file
+extern AppButton g_resetButton; // Defined in main file
+extern AppGestures g_resetGestures; // Defined in main file
+extern AppRetry g_reconnect;    // Defined in main file
+extern AppRateLimiter g_connectLimit; // Defined in main file
+extern AppCircuitBreaker g_connectBreaker; // Defined in main file
+extern AppLinkMonitor g_linkMonitor; // Defined in main file
+extern AppStatusFilter g_statusFilter; // Defined in main file
 extern MooreMachine<AppState, Input, Output> g_machine;  // Defined in main file
 
+//----------------------------------------------------------------------------//
+// Status Polling Configuration
+//----------------------------------------------------------------------------//
+
+// Every WiFi.status() / WiFi.localIP() call goes to the WiFi module, so poll
+// only as often as the current mode needs
+const unsigned long STATUS_POLL_FAST_MS = 100;    // Connecting or waiting for DHCP
+const unsigned long STATUS_POLL_STABLE_MS = 1000; // Connected with an address
+const unsigned long STATUS_POLL_IDLE_MS = 500;    // Disconnected and everything else
+
+/*
+ * Poll interval for the WiFi driver in the given state
+ */
+static unsigned long statusPollInterval(const AppState& state) {
+  switch (state.mode) {
+    case MODE_CONNECTING:
+      return STATUS_POLL_FAST_MS;
+    case MODE_CONNECTED:
+      return state.hasIP ? STATUS_POLL_STABLE_MS : STATUS_POLL_FAST_MS;
+    default:
+      return STATUS_POLL_IDLE_MS;
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Roaming Configuration
+//----------------------------------------------------------------------------//
+
+const unsigned long ROAM_MIN_DWELL_MS = 60000;  // Stay on an AP at least this long between roam scans
+const int32_t ROAM_MIN_GAIN_DB = 8;              // A new AP must be this much stronger to be worth it
+
 //----------------------------------------------------------------------------//
 // WiFi Connection Functions
 //----------------------------------------------------------------------------//
 
-void connectWiFi(const Credentials* creds) {
+bool scanForNetwork(const Credentials* creds, uint8_t* bssid) {
   // Log connection attempt with SSID details
   Serial.print("Connecting to SSID: '");
   Serial.print(creds->ssid);
@@ -46,6 +89,7 @@ void connectWiFi(const Credentials* creds) {
   
   // Search scan results for target network
   bool networkFound = false;
+  int32_t bestRssi = 0;
   for (int i = 0; i < numNetworks; i++) {
     // Display each network: index, SSID, signal strength
     Serial.print(i);
@@ -57,6 +101,11 @@ void connectWiFi(const Credentials* creds) {
     
     // Check if this is our target network (case-sensitive string compare)
     if (strcmp(WiFi.SSID(i), creds->ssid) == 0) {
+      // Remember the strongest access point - the one WiFi.begin() will join
+      if (!networkFound || WiFi.RSSI(i) > bestRssi) {
+        bestRssi = WiFi.RSSI(i);
+        WiFi.BSSID(i, bssid);
+      }
       networkFound = true;
       Serial.println("  ^ Target network found!");
     }
@@ -66,9 +115,16 @@ void connectWiFi(const Credentials* creds) {
   if (!networkFound) {
     Serial.println("ERROR: Target network not found in scan!");
     digitalWrite(wifi_led_pin, LOW);  // Turn off WiFi LED
-    return;  // Early exit
+    return false;  // Early exit
   }
+  
+  return true;
+}
 
+void beginConnection(const Credentials* creds, const uint8_t* bssid, unsigned long now) {
+  // Same access point as last time: skip DHCP with the cached lease
+  applyLease(creds, bssid, now);
+  
   // Begin connection attempt (non-blocking)
   Serial.println("Starting WiFi connection...");
   WiFi.begin(creds->ssid, creds->pass);
@@ -76,6 +132,41 @@ void connectWiFi(const Credentials* creds) {
   // Don't block here - let the Moore machine tick system handle status polling
 }
 
+bool findStrongerAccessPoint(const Credentials* creds, uint8_t* bssid) {
+  uint8_t current[6];
+  WiFi.BSSID(current);
+  int32_t needed = g_linkMonitor.getSmoothed() + ROAM_MIN_GAIN_DB;
+  
+  int numNetworks = WiFi.scanNetworks();  // Blocking call
+  bool found = false;
+  int32_t bestRssi = needed;
+  for (int i = 0; i < numNetworks; i++) {
+    if (strcmp(WiFi.SSID(i), creds->ssid) != 0 || WiFi.RSSI(i) < bestRssi) {
+      continue;
+    }
+    uint8_t candidate[6];
+    WiFi.BSSID(i, candidate);
+    if (memcmp(candidate, current, sizeof(current)) == 0) {
+      continue;  // The access point we are already on
+    }
+    memcpy(bssid, candidate, sizeof(candidate));
+    bestRssi = WiFi.RSSI(i);
+    found = true;
+  }
+  
+  if (found) {
+    Serial.print("Roaming to a stronger access point (");
+    Serial.print(bestRssi);
+    Serial.print(" dBm vs ");
+    Serial.print(g_linkMonitor.getSmoothed());
+    Serial.print(" dBm): ");
+    printMacAddress(bssid);
+  } else {
+    Serial.println("No clearly stronger access point, staying connected");
+  }
+  return found;
+}
+
 //----------------------------------------------------------------------------//
 // Input Processing Functions
 //----------------------------------------------------------------------------//
@@ -96,35 +187,183 @@ Input parseUserInput(char input, AppMode currentMode) {
   }
 }
 
-Input readEvents() {
+Input readEvents(unsigned long now) {
   const AppState& state = g_machine.getState();
   
   // Check for user input via serial (highest priority)
   char input = readSingleChar();
+  if (input == 's' || input == 'S') {
+    // Diagnostics only - no state change, so it bypasses the machine
+    printConnectStats();
+    Serial.print("  status flaps suppressed: ");
+    Serial.println(g_statusFilter.getSuppressed());
+    return Input::none();
+  }
+  if (input == 't' || input == 'T') {
+    printTrace();  // Diagnostics only, like 's'
+    return Input::none();
+  }
   if (input != '\0') {
-    return parseUserInput(input, state.mode);  // Convert char to Input
+    return stamp(parseUserInput(input, state.mode), now);  // Convert char to Input
   }
   
-  // Check for WiFi status changes (hardware polling happens here, not in transition function)
-  int currentWifiStatus = WiFi.status();
-  if (currentWifiStatus != state.wifiStatus) {
-    Serial.print("DEBUG: WiFi status changed from ");
-    Serial.print(state.wifiStatus);
-    Serial.print(" to ");
-    Serial.println(currentWifiStatus);
-    return Input::wifiStatusChanged(currentWifiStatus);
+  // Poll the WiFi driver at the rate the current mode needs, and as soon as
+  // a changed reading has waited out its settle time (the loop sleeps until
+  // then, so waiting for the next regular poll would spin)
+  unsigned long pollInterval = statusPollInterval(state);
+  if (g_statusPoll.getInterval() != pollInterval) {
+    g_statusPoll.setInterval(pollInterval, now);  // Mode changed: new rate from now
+  }
+  bool settleDue = g_statusFilter.isSettling() && g_statusFilter.remainingTime(now) == 0;
+  if (g_statusPoll.expired(now) || settleDue) {
+    g_statusPoll.restart(now);
+    
+    // Check for WiFi status changes (hardware polling happens here, not in transition function)
+    // Only changes that outlast the settle time become inputs; glitches are counted
+    int currentWifiStatus = WiFi.status();
+    if (g_statusFilter.update(currentWifiStatus, state.wifiStatus, now)) {
+      Serial.print("DEBUG: WiFi status changed from ");
+      Serial.print(state.wifiStatus);
+      Serial.print(" to ");
+      Serial.println(currentWifiStatus);
+      return stamp(Input::wifiStatusChanged(currentWifiStatus), now);
+    }
+    
+    // Associated: wait for DHCP to hand out an address
+    if (state.mode == MODE_CONNECTED && !state.hasIP && (uint32_t)WiFi.localIP() != 0) {
+      return stamp(Input::ipAcquired(), now);
+    }
+  }
+  
+  // Upstream reachability: probe while connected with an address
+  Input probe = pollReachability(state, now);
+  if (probe.type != INPUT_NONE) {
+    return probe;
+  }
+  
+  // Link quality: sample RSSI while connected, report threshold crossings
+  if (state.mode == MODE_CONNECTED) {
+    if (g_linkMonitor.sampleDue(now)) {
+      LinkEvent event = g_linkMonitor.sample(WiFi.RSSI(), now);
+      if (event == LINK_EVENT_DEGRADED) {
+        return stamp(Input::linkDegraded(g_linkMonitor.getSmoothed()), now);
+      }
+      if (event == LINK_EVENT_RECOVERED) {
+        return stamp(Input::linkRecovered(g_linkMonitor.getSmoothed()), now);
+      }
+    }
+  } else if (state.mode != MODE_ROAMING) {
+    // Next connection starts from a fresh average. A roam scan keeps the
+    // link, so it keeps its average and degraded flag too: a monitor reset
+    // to "not degraded" would never report the recovery state.linkDegraded
+    // waits for, and roam scans would repeat for as long as the link lasts
+    g_linkMonitor.reset();
+  }
+  
+  // Weak signal: look for a stronger access point, at most once per dwell time
+  if (state.mode == MODE_CONNECTED && state.linkDegraded &&
+      now - state.associatedAt >= ROAM_MIN_DWELL_MS &&
+      now - state.roamCheckedAt >= ROAM_MIN_DWELL_MS) {
+    return stamp(Input::roamRequested(), now);
   }
   
-  // Check if tick timer has expired
-  if (g_tickTimer.expired()) {
-    g_tickTimer.restart();
-    return Input::tick();
+  // Automatic reconnect once the backoff delay has passed, the circuit
+  // breaker is not cooling down and the per-device rate limit allows
+  // another association attempt
+  if (state.mode == MODE_DISCONNECTED && g_reconnect.isDue(now) &&
+      g_connectBreaker.allowRequest(now) && g_connectLimit.tryAcquire(now)) {
+    g_reconnect.due(now);
+    Serial.print("Automatic reconnect, attempt ");
+    Serial.println(g_reconnect.getAttempts());
+    return stamp(Input::retryConnection(), now);
   }
   
-  // Check for reset button press (optional)
-  if (g_resetButton.wasPressed()) {
-    return Input::requestCredentials();
+  // Check if tick timer has expired (ticks only drive the connect timeout)
+  if (state.mode == MODE_CONNECTING && g_tickTimer.expired(now)) {
+    g_tickTimer.restart(now);
+    return stamp(Input::tick(), now);
+  }
+  
+  // Check for reset button gestures (optional)
+  // Click behaves like 'r', holding the button behaves like 'c'
+  // Edges go in with the time they happened, so a click made while the loop
+  // was blocked (e.g. in a scan) still counts; at most one gesture per
+  // iteration, later edges stay queued for the next one
+  g_resetButton.update(now);
+  GestureType gesture = GESTURE_NONE;
+  bool pressed;
+  AppButton::time_type edgeAt;
+  while (gesture == GESTURE_NONE && g_resetButton.nextEdge(pressed, edgeAt)) {
+    gesture = pressed ? g_resetGestures.press(edgeAt) : g_resetGestures.release(edgeAt);
+  }
+  if (gesture == GESTURE_NONE) {
+    gesture = g_resetGestures.poll(now);
+  }
+  
+  // Stamp with when the gesture happened, but never before the last input
+  unsigned long gestureAt = g_resetGestures.getGestureTime();
+  if ((long)(gestureAt - state.lastUpdate) < 0) {
+    gestureAt = state.lastUpdate;
+  }
+  switch (gesture) {
+    case GESTURE_CLICK:
+      if (state.mode == MODE_DISCONNECTED) {
+        return stamp(Input::retryConnection(), gestureAt);
+      }
+      break;
+    case GESTURE_LONG_PRESS:
+      return stamp(Input::requestCredentials(), gestureAt);
+    default:
+      break;
   }
   
   return Input::none();
 }
+
+//----------------------------------------------------------------------------//
+// Automatic Reconnect
+//----------------------------------------------------------------------------//
+
+const unsigned long RECONNECT_SPREAD_MS = 30000;  // First retries spread over 30s per fleet
+
+void observeReconnectSchedule(const AppState& oldState, const AppState& newState) {
+  if (oldState.mode == newState.mode) {
+    return;
+  }
+  
+  if (newState.mode == MODE_DISCONNECTED) {
+    // A failed attempt counts towards the circuit breaker; a lost link does not
+    if (oldState.mode == MODE_CONNECTING &&
+        g_connectBreaker.recordFailure(newState.lastUpdate)) {
+      Serial.print("Too many failed attempts, pausing automatic reconnects for ");
+      Serial.print(g_connectBreaker.getCoolDown() / 1000);
+      Serial.println(" s");
+    }
+    
+    // Back off, measured from the failing input
+    if (g_reconnect.schedule(newState.lastUpdate)) {
+      Serial.print("Reconnecting in ");
+      Serial.print(g_reconnect.getLastDelay() / 1000.0, 1);
+      Serial.println(" s");
+    }
+  } else if (newState.mode == MODE_CONNECTED || newState.mode == MODE_ENTERING_CREDENTIALS) {
+    // Connected, or about to try different credentials: start over
+    g_reconnect.reset();
+    g_connectBreaker.recordSuccess();
+  } else if (oldState.mode == MODE_DISCONNECTED) {
+    // Left DISCONNECTED some other way (e.g. 'r'): the pending retry is moot
+    g_reconnect.cancel();
+  }
+}
+
+void seedReconnectJitter() {
+  uint8_t mac[6];
+  WiFi.macAddress(mac);
+  uint32_t seed = deviceSeed(mac, sizeof(mac));
+  g_reconnect.seed(seed);
+  seedProbeRetry(seed);  // Probe retries after an upstream outage spread out too
+  
+  // When an AP reboots, every board loses it at the same instant.
+  // A fixed per-board offset spreads the first retries over this window.
+  g_reconnect.setInitialSpread(RECONNECT_SPREAD_MS);
+}
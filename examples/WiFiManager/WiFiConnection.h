@@ -8,11 +8,33 @@
 //----------------------------------------------------------------------------//
 
 /**
- * Initiate WiFi connection to specified network
- * Performs network scan first to verify target exists
+ * Scan phase: check that the target network is in range (blocking)
  * @param creds Pointer to credentials for target network
+ * @param bssid Receives the BSSID (6 bytes) of the strongest matching access point
+ * @return true if the network was found
  */
-void connectWiFi(const Credentials* creds);
+bool scanForNetwork(const Credentials* creds, uint8_t* bssid);
+
+/**
+ * Associate phase: start connecting to the network (WiFi.begin())
+ * Completion is detected by polling WiFi.status() in readEvents()
+ * Reuses the cached lease if bssid is the access point it was issued through
+ * @param creds Pointer to credentials for target network
+ * @param bssid BSSID reported by scanForNetwork()
+ * @param now Current timestamp
+ */
+void beginConnection(const Credentials* creds, const uint8_t* bssid, unsigned long now);
+
+/**
+ * Roam scan: look for another access point on the same SSID that is
+ * clearly stronger than the current link (blocking, stays connected)
+ * WiFi.begin() cannot pin a BSSID, so reassociating relies on the driver
+ * picking the strongest access point - the one found here
+ * @param creds Credentials of the current network
+ * @param bssid Receives the BSSID (6 bytes) of the stronger access point
+ * @return true if a stronger access point was found
+ */
+bool findStrongerAccessPoint(const Credentials* creds, uint8_t* bssid);
 
 /**
  * Parse single character user input into Input symbols
@@ -26,8 +48,26 @@ Input parseUserInput(char input, AppMode currentMode);
 /**
  * Read events from environment and convert to Input symbols
  * This is the input layer of the Moore machine
+ * Every returned input is stamped with `now`
+ * @param now Timestamp captured once for this loop iteration
  * @return Input symbol representing current environmental state
  */
-Input readEvents();
+Input readEvents(unsigned long now);
+
+/**
+ * Observer: Schedule automatic reconnects with backoff
+ * Schedules a retry on entering DISCONNECTED and forgets the
+ * failure history once connected
+ * @param oldState Previous state
+ * @param newState Current state
+ */
+void observeReconnectSchedule(const AppState& oldState, const AppState& newState);
+
+/**
+ * Seed the reconnect and probe retry jitter and the initial spread from
+ * this board's MAC address
+ * Call once in setup() after the WiFi module is up
+ */
+void seedReconnectJitter();
 
 #endif // WIFI_CONNECTION_H
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "WiFiLease.h"
+#include "kvstore_global_api.h"
+#include <mbed_error.h>
+#include <WiFi.h>
+
+//----------------------------------------------------------------------------//
+// Configuration
+//----------------------------------------------------------------------------//
+
+// Set to false to always use DHCP
+const bool LEASE_FAST_PATH_ENABLED = true;
+
+// Longest a lease is reused after DHCP handed it out; well inside the
+// shortest leases handed out in practice
+const unsigned long LEASE_MAX_AGE_MS = 30UL * 60 * 1000;
+
+// Key name for persistent storage in KVStore (flash memory)
+const char* KEY_LEASE = "wifi_lease";
+
+// Stored blobs start with this tag; change it whenever StoredLease changes
+const uint32_t LEASE_MAGIC = 0x57464C31;  // "WFL1"
+
+//----------------------------------------------------------------------------//
+// Lease Storage
+//----------------------------------------------------------------------------//
+
+/*
+ * Addresses are kept as plain bytes so the struct can be written to and
+ * read from flash as-is.
+ */
+struct StoredLease {
+  uint32_t magic;
+  char ssid[64];        // Network the lease was issued on
+  uint8_t bssid[6];     // Access point the lease was issued through
+  uint8_t ip[4];
+  uint8_t gateway[4];
+  uint8_t subnet[4];
+  uint8_t dns[4];
+};
+
+static StoredLease g_lease;
+static bool g_leaseValid = false;    // g_lease holds a usable lease
+static bool g_leaseApplied = false;  // Current attempt uses the cached lease
+static bool g_staticConfig = false;  // WiFi.config() was called with a lease
+static bool g_leaseProbed = false;   // A probe has run since the lease was applied
+static unsigned long g_leaseAcquiredAt = 0;  // When DHCP handed out g_lease
+
+//----------------------------------------------------------------------------//
+// Helpers
+//----------------------------------------------------------------------------//
+
+static void copyAddress(uint8_t* dest, const IPAddress& address) {
+  for (uint8_t i = 0; i < 4; i++) {
+    dest[i] = address[i];
+  }
+}
+
+static IPAddress toAddress(const uint8_t* bytes) {
+  return IPAddress(bytes[0], bytes[1], bytes[2], bytes[3]);
+}
+
+//----------------------------------------------------------------------------//
+// Persistence Functions
+//----------------------------------------------------------------------------//
+
+void loadLease(unsigned long now) {
+  StoredLease stored;
+  size_t actualSize = 0;
+  int result = kv_get(KEY_LEASE, &stored, sizeof(stored), &actualSize);
+  
+  if (result == MBED_ERROR_ITEM_NOT_FOUND) {
+    return;  // First run - no lease yet
+  }
+  if (result != MBED_SUCCESS) {
+    // The lease only speeds things up: report and carry on with DHCP
+    Serial.print("kv_get failed for KEY_LEASE with ");
+    Serial.println(result);
+    return;
+  }
+  if (actualSize != sizeof(stored) || stored.magic != LEASE_MAGIC) {
+    Serial.println("Stored lease has an old layout, using DHCP");
+    return;
+  }
+  
+  g_lease = stored;
+  g_leaseValid = true;
+  g_leaseAcquiredAt = now;
+}
+
+static void saveLease() {
+  int result = kv_set(KEY_LEASE, &g_lease, sizeof(g_lease), 0);
+  if (result != MBED_SUCCESS) {
+    Serial.print("'kv_set(KEY_LEASE, ...)' failed with error code ");
+    Serial.println(result);
+  }
+}
+
+void forgetLease() {
+  if (!g_leaseValid) {
+    return;
+  }
+  g_leaseValid = false;
+  int result = kv_remove(KEY_LEASE);
+  if (result != MBED_SUCCESS && result != MBED_ERROR_ITEM_NOT_FOUND) {
+    Serial.print("'kv_remove(KEY_LEASE)' failed with error code ");
+    Serial.println(result);
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Lease Functions
+//----------------------------------------------------------------------------//
+
+bool applyLease(const Credentials* creds, const uint8_t* bssid, unsigned long now) {
+  if (g_leaseValid && now - g_leaseAcquiredAt >= LEASE_MAX_AGE_MS) {
+    Serial.println("Cached lease too old, using DHCP");
+    forgetLease();
+  }
+  
+  g_leaseApplied = LEASE_FAST_PATH_ENABLED && g_leaseValid &&
+                   strcmp(g_lease.ssid, creds->ssid) == 0 &&
+                   memcmp(g_lease.bssid, bssid, sizeof(g_lease.bssid)) == 0;
+  g_leaseProbed = false;
+  
+  if (g_leaseApplied) {
+    WiFi.config(toAddress(g_lease.ip), toAddress(g_lease.dns),
+                toAddress(g_lease.gateway), toAddress(g_lease.subnet));
+    g_staticConfig = true;
+    Serial.print("Reusing cached lease ");
+    Serial.println(toAddress(g_lease.ip));
+  } else if (g_staticConfig) {
+    // An all-zero configuration hands addressing back to DHCP
+    WiFi.config(IPAddress(), IPAddress(), IPAddress(), IPAddress());
+    g_staticConfig = false;
+  }
+  return g_leaseApplied;
+}
+
+bool leaseUnverified() {
+  return g_leaseApplied && !g_leaseProbed;
+}
+
+void leaseProbed(bool answered) {
+  if (!leaseUnverified()) {
+    return;
+  }
+  g_leaseProbed = true;
+  if (!answered) {
+    // The address may be taken: it still associates, but traffic goes astray
+    Serial.println("First probe failed with a cached lease, next connect uses DHCP");
+    g_leaseApplied = false;
+    forgetLease();
+  }
+}
+
+void observeLease(const AppState& oldState, const AppState& newState) {
+  // The cached lease did not get us connected: it may be stale or taken
+  if (g_leaseApplied && oldState.mode == MODE_CONNECTING &&
+      newState.mode == MODE_DISCONNECTED) {
+    Serial.println("Cached lease failed, falling back to DHCP");
+    g_leaseApplied = false;
+    forgetLease();
+    return;
+  }
+  
+  // Nothing gets through with the cached lease: it may be stale
+  if (g_leaseApplied && !oldState.upstreamLost && newState.upstreamLost) {
+    Serial.println("Upstream lost with a cached lease, next connect uses DHCP");
+    g_leaseApplied = false;
+    forgetLease();
+    return;
+  }
+  
+  if (oldState.hasIP || !newState.hasIP) {
+    return;
+  }
+  
+  uint8_t bssid[6];
+  WiFi.BSSID(bssid);
+  
+  if (g_leaseApplied) {
+    // The driver picked another access point than the scan suggested
+    if (memcmp(g_lease.bssid, bssid, sizeof(bssid)) != 0) {
+      Serial.println("Joined a different access point, next connect uses DHCP");
+      forgetLease();
+    }
+    return;
+  }
+  
+  // Fresh DHCP lease: cache it, writing flash only if something changed
+  StoredLease lease;
+  memset(&lease, 0, sizeof(lease));
+  lease.magic = LEASE_MAGIC;
+  memcpy(lease.ssid, newState.credentials.ssid,
+         strnlen(newState.credentials.ssid, sizeof(lease.ssid) - 1));
+  memcpy(lease.bssid, bssid, sizeof(lease.bssid));
+  copyAddress(lease.ip, WiFi.localIP());
+  copyAddress(lease.gateway, WiFi.gatewayIP());
+  copyAddress(lease.subnet, WiFi.subnetMask());
+  copyAddress(lease.dns, WiFi.dnsIP(0));
+  
+  g_leaseAcquiredAt = newState.lastUpdate;
+  if (!g_leaseValid || memcmp(&lease, &g_lease, sizeof(lease)) != 0) {
+    g_lease = lease;
+    g_leaseValid = true;
+    saveLease();
+  }
+}
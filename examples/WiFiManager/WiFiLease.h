@@ -0,0 +1,69 @@
+#ifndef WIFI_LEASE_H
+#define WIFI_LEASE_H
+
+#include "WiFiTypes.h"
+
+//----------------------------------------------------------------------------//
+// Lease Cache (persistent static-IP fast path)
+//----------------------------------------------------------------------------//
+
+/*
+ * After a DHCP connection the address, gateway, netmask and DNS server are
+ * stored together with the SSID and access point BSSID. When the next scan
+ * shows the same access point as the strongest one for that SSID, the cached
+ * lease is applied with WiFi.config() and the DHCP exchange is skipped.
+ *
+ * A lease is reused for at most LEASE_MAX_AGE_MS after DHCP handed it
+ * out, since the server may give an expired address to someone else. The
+ * board has no wall clock, so a lease loaded from flash counts as handed
+ * out at boot.
+ *
+ * If an attempt with the cached lease fails, the first reachability probe
+ * after applying it fails (a conflicting address still associates fine),
+ * or the board ends up on a different access point, the lease is
+ * forgotten and the next attempt goes back to DHCP.
+ */
+
+/**
+ * Load the cached lease from flash memory
+ * Starts without a lease if none is stored or the layout changed
+ * @param now Current timestamp (taken as the lease's age origin)
+ */
+void loadLease(unsigned long now);
+
+/**
+ * Configure addressing for the next WiFi.begin()
+ * Applies the cached lease if it belongs to this SSID and access point,
+ * otherwise makes sure DHCP is used
+ * @param creds Credentials about to be used
+ * @param bssid BSSID of the strongest access point for the SSID in the last scan
+ * @param now Current timestamp
+ * @return true if the cached lease was applied
+ */
+bool applyLease(const Credentials* creds, const uint8_t* bssid, unsigned long now);
+
+/**
+ * Check if the applied lease still waits for its first reachability probe
+ */
+bool leaseUnverified();
+
+/**
+ * Report a reachability probe result (see WiFiProbe)
+ * The first probe after applying the cached lease decides whether it is kept
+ * @param answered Whether the probe host answered
+ */
+void leaseProbed(bool answered);
+
+/**
+ * Drop the cached lease (in RAM and flash)
+ */
+void forgetLease();
+
+/**
+ * Observer: Cache DHCP leases and fall back to DHCP when a cached one fails
+ * @param oldState Previous state
+ * @param newState Current state
+ */
+void observeLease(const AppState& oldState, const AppState& newState);
+
+#endif // WIFI_LEASE_H
@@ -6,7 +6,7 @@
  * providing predictable state management for embedded systems.
  * 
  * Moore Machine M = (Q, Σ, δ, λ, q₀) where:
- * - Q: State space {INITIALIZING, CONNECTING, CONNECTED, DISCONNECTED, ENTERING_CREDENTIALS}
+ * - Q: State space {INITIALIZING, CONNECTING, CONNECTED, DISCONNECTED, ENTERING_CREDENTIALS, ROAMING}
  * - Σ: Input alphabet {RETRY_CONNECTION, REQUEST_CREDENTIALS, CREDENTIALS_ENTERED, WIFI_CONNECTED, etc.}
  * - δ: Transition function (implemented as `transitionFunction`)
  * - λ: Output function (implemented as `outputFunction` - generates effects)
@@ -33,16 +33,29 @@
  * 
  * Persistent Storage:
  * - WiFi credentials stored in KVStore (key-value storage in flash memory)
+ * - Histograms of connect phase times (scan, associate, DHCP, online); the
+ *   associate times are used to learn the connection timeout
+ * - Last DHCP lease and access point, reused as static config on reconnect
  * - Survives power cycles and board resets
  * 
  * User Interface:
  * - Serial monitor for credential input and status display
  * - Press 'c' to change WiFi credentials
- * - Press 'r' to retry connection when disconnected
+ * - Press 's' to print connect phase statistics and suppressed status flaps
+ * - Press 't' to print the input trace (replayable on a PC, see sim/WiFiReplay.cpp)
+ * - Press 'r' to retry connection when disconnected (retries also happen
+ *   automatically with exponential backoff, per-device jitter and a rate limit,
+ *   paused by a circuit breaker after repeated failures)
+ * - Probes a host over TCP while connected; if it stays unreachable the link
+ *   is dropped once and reconnected
+ * - Warns when the smoothed signal strength gets weak, and when it recovers;
+ *   if it stays weak, moves to a clearly stronger access point on the same SSID
+ * - Reset button (pin 4): click to retry, hold to change credentials
  * 
  * State Transition Diagram:
  * INITIALIZING → CONNECTING → CONNECTED ⟷ DISCONNECTED
- *                     ↓           ↗
+ *                     ↓    ↖      ⇅
+ *                     ↓     ROAMING (weak signal: scan for a stronger AP)
  *              ENTERING_CREDENTIALS
  */
 
@@ -61,6 +74,10 @@
 #include "WiFiConnection.h"
 #include "WiFiUI.h"
 #include "WiFiStateMachine.h"
+#include "WiFiMetrics.h"
+#include "WiFiLease.h"
+#include "WiFiProbe.h"
+#include "WiFiTrace.h"
 
 using namespace MooreArduino;
 
@@ -100,8 +117,23 @@ const int wifi_led_pin = 3;   // WiFi status LED (on when connected, blinks when
 MooreMachine<AppState, Input, Output> g_machine(transitionFunction, AppState());
 
 // Global utilities
-Timer g_tickTimer(100);  // 100ms tick rate (10Hz)
-Button g_resetButton(4); // Optional reset button on pin 4
+AppClock g_clock;           // One time snapshot per loop iteration
+AppTimer g_tickTimer(100);  // 100ms tick rate (10Hz)
+AppTimer g_statusPoll(100); // WiFi driver polling, rate set per mode in readEvents()
+AppButton g_resetButton(4); // Optional reset button on pin 4 (interrupt-driven)
+AppGestures g_resetGestures; // Click = retry, long press = change credentials
+AppIdle g_idle(50);         // Sleep between deadlines, polling Serial and the button at least every 50ms
+AppRetry g_reconnect(2000, 120000); // Automatic reconnect: 2s base delay, 2 min cap, never gives up
+AppRateLimiter g_connectLimit(3, 30000); // At most 3 automatic attempts at once, then one per 30s
+AppCircuitBreaker g_connectBreaker(5, 300000); // 5 failed attempts in a row → no scans for 5 min
+AppLinkMonitor g_linkMonitor(-75, -68, 2000); // Weak below -75 dBm, recovered above -68, RSSI every 2s
+AppStatusFilter g_statusFilter(WL_CONNECTED, 0, 3000); // Link up reported at once, down only after 3s
+
+// Reset button ISR: timestamp the edge and end any idle sleep immediately
+void onResetButtonEdge() {
+  g_resetButton.onEdge();
+  g_idle.wake();
+}
 
 //----------------------------------------------------------------------------//
 // Arduino Setup Function
@@ -144,23 +176,44 @@ void setup() {
   // Set up store observers for reactive UI updates
   g_machine.addStateObserver(observeConnectedState);
   g_machine.addStateObserver(observeDisconnectedState);
+  g_machine.addStateObserver(observeLinkQuality);
+  g_machine.addStateObserver(observeUpstream);
   g_machine.addStateObserver(observeCredentialChanges);
+  g_machine.addStateObserver(observeReconnectSchedule);
+  g_machine.addStateObserver(observeConnectPhases);
+  g_machine.addStateObserver(observeLease);
+  
+  // Record every input from boot on (printed with 't', replayed on a PC)
+  g_machine.setInputRecorder(recordInput);
+  
+  // Spread automatic reconnects of different boards apart
+  seedReconnectJitter();
   
   // Set up output function
   g_machine.setOutputFunction(outputFunction);
   
-  // Start tick timer
-  g_tickTimer.start();
+  // Capture reset button edges from now on
+  g_resetButton.begin(onResetButtonEdge);
+  
+  // Start tick timer (periodic: late ticks don't push later ones back)
+  g_tickTimer.setPeriodic();
+  g_tickTimer.start(g_clock.update());
+  g_statusPoll.start(g_clock.update());
+  
+  // Restore learned connect times (adaptive connection timeout) and the
+  // cached lease (static-IP fast path)
+  loadMetrics();
+  loadLease(g_clock.update());
   
   // Attempt to load saved WiFi credentials from flash memory
   Credentials loadedCreds;
   if (!loadCredentials(&loadedCreds)) {
     Serial.println("No stored credentials.");
     // No credentials found - start credential entry process
-    g_machine.step(Input::requestCredentials());
+    g_machine.step(stamp(Input::requestCredentials(), g_clock.update()));
   } else {
     // Credentials found - inject them into state and attempt to connect
-    g_machine.step(Input::credentialsEntered(loadedCreds));
+    g_machine.step(stamp(Input::credentialsEntered(loadedCreds), g_clock.update()));
   }
 }
 
@@ -171,8 +224,11 @@ void setup() {
 void loop() {
   const AppState& state = g_machine.getState();
   
+  // 0. Capture a single timestamp shared by every component this iteration
+  unsigned long now = g_clock.update();
+  
   // 1. Read events from environment (user input, hardware status)
-  Input input = readEvents();
+  Input input = readEvents(now);
   
   if (input.type != INPUT_NONE) {
     DEBUG_PRINT("DEBUG: Input type=");
@@ -180,21 +236,22 @@ void loop() {
     
     // Special handling for credential entry (only blocking operation)
     if (input.type == INPUT_REQUEST_CREDENTIALS) {
-      g_machine.step(input);  // First, change to credential entry mode
+      g_machine.step(input, now);  // First, change to credential entry mode
       
       // Blocking credential prompt (breaks Moore pattern but necessary for UX)
       Credentials newCreds;
       if (promptForCredentialsBlocking(&newCreds)) {
         DEBUG_PRINTLN("DEBUG: About to process credentialsEntered input");
-        g_machine.step(Input::credentialsEntered(newCreds));  // Process entered credentials
+        // Re-read the clock: the prompt blocked for an unknown amount of time
+        g_machine.step(stamp(Input::credentialsEntered(newCreds), g_clock.update()));
         DEBUG_PRINTLN("DEBUG: After processing credentialsEntered input");
       } else {
         // Credential entry failed - revert to previous state
-        g_machine.step(Input::tick());  // Tick will update mode based on WiFi status
+        g_machine.step(stamp(Input::tick(), g_clock.update()));  // Tick will update mode based on WiFi status
       }
     } else {
       // Normal case - process input through Moore machine
-      g_machine.step(input);
+      g_machine.step(input, now);
     }
     
     // Execute effect when state changes (after processing input)
@@ -205,12 +262,42 @@ void loop() {
     if (followUpInput.type != INPUT_NONE) {
       DEBUG_PRINT("DEBUG: Follow-up input type=");
       DEBUG_PRINTLN(followUpInput.type);
-      g_machine.step(followUpInput);
+      g_machine.step(followUpInput, g_clock.now());
     }
   }
   
   // Always update LEDs (needed for blinking and responsive indicators)
-  updateLEDs(state.mode);
+  updateLEDs(state.mode, now);
   
-  delay(10);  // Small delay to prevent overwhelming the system
+  // Sleep until the next deadline instead of a fixed delay.
+  // Ticks and LED blinking only matter while connecting; otherwise the loop
+  // just wakes often enough to poll Serial and the button; the WiFi driver
+  // is polled on its own per-mode schedule.
+  g_idle.begin();
+  if (state.mode == MODE_CONNECTING) {
+    g_idle.until(g_tickTimer, now);
+    g_idle.within(LED_BLINK_HALF_PERIOD_MS - (now % LED_BLINK_HALF_PERIOD_MS));
+  }
+  if (state.mode == MODE_DISCONNECTED && g_reconnect.isScheduled()) {
+    // Next automatic reconnect, delayed by the rate limit or breaker cool-down
+    unsigned long wait = g_reconnect.remainingTime(now);
+    unsigned long limited = g_connectLimit.timeUntilAvailable(now);
+    unsigned long coolDown = g_connectBreaker.remainingCoolDown(now);
+    if (limited > wait) wait = limited;
+    if (coolDown > wait) wait = coolDown;
+    g_idle.within(wait);
+  }
+  if (state.mode == MODE_CONNECTED) {
+    g_idle.until(g_linkMonitor, now);  // Next RSSI sample
+  }
+  if (state.mode == MODE_CONNECTED && state.hasIP) {
+    g_idle.within(timeUntilProbe(now));  // Next reachability probe
+  }
+  g_idle.until(g_statusPoll, now);    // Next WiFi driver poll
+  g_idle.until(g_statusFilter, now);  // WiFi status change waiting to settle
+  g_idle.until(g_resetGestures, now);  // Pending long press / click
+  if (g_resetButton.hasEdges()) {
+    g_idle.within(0);  // Button edges left over for the next gesture
+  }
+  g_idle.sleep(now);
 }
@@ -0,0 +1,189 @@
+#include "WiFiMetrics.h"
+#include "kvstore_global_api.h"
+#include <mbed_error.h>
+#include <MooreArduino.h>
+
+using namespace MooreArduino;
+
+//----------------------------------------------------------------------------//
+// Configuration
+//----------------------------------------------------------------------------//
+
+// Key name for persistent storage in KVStore (flash memory)
+const char* KEY_METRICS = "wifi_metrics";
+
+// Stored blobs start with this tag; change it whenever StoredMetrics changes
+const uint32_t METRICS_MAGIC = 0x57464D32;  // "WFM2"
+
+// Adaptive timeout: percentile of past connect times, scaled and bounded
+const uint8_t CONNECT_TIMEOUT_PERCENTILE = 99;
+const unsigned long CONNECT_TIMEOUT_SCALE_NUM = 3;   // × 1.5
+const unsigned long CONNECT_TIMEOUT_SCALE_DEN = 2;
+const unsigned long CONNECT_TIMEOUT_MIN_MS = 5000;   // Never give up sooner than 5s
+const unsigned long CONNECT_TIMEOUT_MIN_SAMPLES = 5; // Use the default until then
+
+//----------------------------------------------------------------------------//
+// Metrics Storage
+//----------------------------------------------------------------------------//
+
+/*
+ * Everything persisted in one blob. Histogram is a plain array of
+ * counters, so the struct can be written to and read from flash as-is.
+ */
+struct StoredMetrics {
+  uint32_t magic;
+  Histogram<> phases[PHASE_COUNT];  // Milliseconds, indexed by ConnectPhase
+};
+
+static StoredMetrics g_metrics = { METRICS_MAGIC, {} };
+
+// Set when the associate phase of the current connection was timed, so
+// DHCP and online samples are only taken for attempts we started
+static bool g_phaseTimingActive = false;
+
+static const char* const PHASE_NAMES[PHASE_COUNT] = { "scan", "associate", "dhcp", "online" };
+
+//----------------------------------------------------------------------------//
+// Persistence Functions
+//----------------------------------------------------------------------------//
+
+void loadMetrics() {
+  StoredMetrics stored;
+  size_t actualSize = 0;
+  int result = kv_get(KEY_METRICS, &stored, sizeof(stored), &actualSize);
+  
+  if (result == MBED_ERROR_ITEM_NOT_FOUND) {
+    return;  // First run - keep empty metrics
+  }
+  if (result != MBED_SUCCESS) {
+    // Metrics are nice to have: report and carry on with empty ones
+    Serial.print("kv_get failed for KEY_METRICS with ");
+    Serial.println(result);
+    return;
+  }
+  if (actualSize != sizeof(stored) || stored.magic != METRICS_MAGIC) {
+    Serial.println("Stored metrics have an old layout, starting fresh");
+    return;
+  }
+  
+  g_metrics = stored;
+  Serial.print("Loaded ");
+  Serial.print(g_metrics.phases[PHASE_ONLINE].getCount());
+  Serial.println(" connect time samples");
+}
+
+void saveMetrics() {
+  int result = kv_set(KEY_METRICS, &g_metrics, sizeof(g_metrics), 0);
+  if (result != MBED_SUCCESS) {
+    Serial.print("'kv_set(KEY_METRICS, ...)' failed with error code ");
+    Serial.println(result);
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Metrics Collection
+//----------------------------------------------------------------------------//
+
+void recordPhase(ConnectPhase phase, unsigned long elapsedMs) {
+  g_metrics.phases[phase].record(elapsedMs);
+}
+
+void observeConnectPhases(const AppState& oldState, const AppState& newState) {
+  // Associate: only attempts that got as far as WiFi.begin() have a start time
+  if (oldState.mode == MODE_CONNECTING && newState.mode == MODE_CONNECTED &&
+      !oldState.shouldReconnect) {
+    unsigned long elapsed = newState.lastUpdate - oldState.connectStartedAt;
+    recordPhase(PHASE_ASSOCIATE, elapsed);
+    g_phaseTimingActive = true;
+    
+    Serial.print("Associated in ");
+    Serial.print(elapsed);
+    Serial.print(" ms, next timeout ");
+    Serial.print(adaptiveConnectTimeout());
+    Serial.println(" ms");
+  }
+  
+  // Associate timed out: the attempt took at least the timeout. Record that
+  // as a (censored) sample too, or the learned timeout would only ever see
+  // the attempts that were fast enough and keep cutting slow ones short
+  if (oldState.mode == MODE_CONNECTING && newState.mode == MODE_DISCONNECTED &&
+      !oldState.shouldReconnect &&
+      newState.lastUpdate - oldState.connectStartedAt > oldState.connectTimeout) {
+    recordPhase(PHASE_ASSOCIATE, oldState.connectTimeout);
+    
+    Serial.print("Associate timed out after ");
+    Serial.print(oldState.connectTimeout);
+    Serial.print(" ms, next timeout ");
+    Serial.print(adaptiveConnectTimeout());
+    Serial.println(" ms");
+  }
+  
+  // DHCP and online: the address arrived for a connection we timed
+  if (!oldState.hasIP && newState.hasIP && g_phaseTimingActive) {
+    g_phaseTimingActive = false;
+    unsigned long dhcp = newState.lastUpdate - newState.associatedAt;
+    unsigned long online = newState.lastUpdate - newState.attemptStartedAt;
+    recordPhase(PHASE_DHCP, dhcp);
+    recordPhase(PHASE_ONLINE, online);
+    saveMetrics();
+    
+    Serial.print("Got IP after ");
+    Serial.print(dhcp);
+    Serial.print(" ms, online in ");
+    Serial.print(online);
+    Serial.println(" ms");
+  }
+  
+  // Link dropped before DHCP finished: nothing more to time
+  if (newState.mode != MODE_CONNECTED) {
+    g_phaseTimingActive = false;
+  }
+}
+
+/*
+ * Print one percentile; the last bucket has no upper end, so print its floor
+ */
+static void printPercentile(const Histogram<>& phase, uint8_t percent) {
+  Serial.print(" p");
+  Serial.print(percent);
+  Serial.print("=");
+  unsigned long value = phase.percentile(percent);
+  if (value >= Histogram<>::rangeLimit()) {
+    Serial.print(">=");
+    value = Histogram<>::rangeLimit();
+  }
+  Serial.print(value);
+}
+
+void printConnectStats() {
+  Serial.println("Connect phase times (ms):");
+  for (uint8_t i = 0; i < PHASE_COUNT; i++) {
+    const Histogram<>& phase = g_metrics.phases[i];
+    Serial.print("  ");
+    Serial.print(PHASE_NAMES[i]);
+    Serial.print(": n=");
+    Serial.print(phase.getCount());
+    printPercentile(phase, 50);
+    printPercentile(phase, 90);
+    printPercentile(phase, 99);
+    Serial.println();
+  }
+  Serial.print("  connect timeout: ");
+  Serial.println(adaptiveConnectTimeout());
+}
+
+unsigned long adaptiveConnectTimeout() {
+  if (g_metrics.phases[PHASE_ASSOCIATE].getCount() < CONNECT_TIMEOUT_MIN_SAMPLES) {
+    return DEFAULT_CONNECT_TIMEOUT_MS;
+  }
+  
+  unsigned long slowest = g_metrics.phases[PHASE_ASSOCIATE].percentile(CONNECT_TIMEOUT_PERCENTILE);
+  if (slowest >= DEFAULT_CONNECT_TIMEOUT_MS) {
+    return DEFAULT_CONNECT_TIMEOUT_MS;  // Also keeps the scaling below from overflowing
+  }
+  
+  unsigned long timeout = slowest * CONNECT_TIMEOUT_SCALE_NUM / CONNECT_TIMEOUT_SCALE_DEN;
+  if (timeout < CONNECT_TIMEOUT_MIN_MS) timeout = CONNECT_TIMEOUT_MIN_MS;
+  if (timeout > DEFAULT_CONNECT_TIMEOUT_MS) timeout = DEFAULT_CONNECT_TIMEOUT_MS;
+  return timeout;
+}
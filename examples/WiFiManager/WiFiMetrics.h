@@ -0,0 +1,65 @@
+#ifndef WIFI_METRICS_H
+#define WIFI_METRICS_H
+
+#include "WiFiTypes.h"
+
+//----------------------------------------------------------------------------//
+// Connection Metrics (persistent)
+//----------------------------------------------------------------------------//
+
+/**
+ * Phases of a connection attempt, each timed into its own histogram
+ * Slow scans point at RF, slow association at the AP or authentication,
+ * slow DHCP at the network behind the AP
+ */
+enum ConnectPhase {
+  PHASE_SCAN,       // Network scan before WiFi.begin()
+  PHASE_ASSOCIATE,  // WiFi.begin() → WL_CONNECTED (also drives the timeout)
+  PHASE_DHCP,       // WL_CONNECTED → IP address assigned
+  PHASE_ONLINE,     // Scan start → IP address assigned (whole attempt)
+  PHASE_COUNT
+};
+
+/**
+ * Load connection metrics from flash memory
+ * Starts with empty metrics if none are stored or the layout changed
+ */
+void loadMetrics();
+
+/**
+ * Persist connection metrics to flash memory using KVStore
+ */
+void saveMetrics();
+
+/**
+ * Record one phase duration measured outside the machine (the scan)
+ * @param phase Phase the sample belongs to
+ * @param elapsedMs Duration in milliseconds
+ */
+void recordPhase(ConnectPhase phase, unsigned long elapsedMs);
+
+/**
+ * Observer: Record associate, DHCP and total connect times
+ * An attempt that timed out counts as an associate sample at its timeout,
+ * so slow networks widen the learned timeout instead of being cut off
+ * Metrics are saved once per connection, when the IP address arrives
+ * @param oldState Previous state
+ * @param newState Current state
+ */
+void observeConnectPhases(const AppState& oldState, const AppState& newState);
+
+/**
+ * Print count and p50/p90/p99 of every phase to serial
+ */
+void printConnectStats();
+
+/**
+ * Connection timeout learned from past attempts
+ * p99 of observed associate times × 1.5, bounded to
+ * [CONNECT_TIMEOUT_MIN_MS, DEFAULT_CONNECT_TIMEOUT_MS];
+ * DEFAULT_CONNECT_TIMEOUT_MS until enough samples exist
+ * @return Timeout in milliseconds for the next attempt
+ */
+unsigned long adaptiveConnectTimeout();
+
+#endif // WIFI_METRICS_H
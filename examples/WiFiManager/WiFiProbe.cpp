@@ -0,0 +1,156 @@
+#include "WiFiProbe.h"
+#include "WiFiLease.h"
+#include <WiFi.h>
+#include <MooreArduino.h>
+
+using namespace MooreArduino;
+
+//----------------------------------------------------------------------------//
+// Configuration
+//----------------------------------------------------------------------------//
+
+// Host that must be reachable for the connection to count as working,
+// resolved once and then probed by address. Set to "" to probe the
+// gateway instead (only detects a dead LAN/AP). A host build can point
+// this at 127.0.0.1 and a local listener.
+const char* PROBE_HOST = "connectivitycheck.gstatic.com";
+const uint16_t PROBE_PORT = 80;
+
+const unsigned long PROBE_INTERVAL_MS = 30000;     // Between probes while upstream works
+const unsigned long PROBE_TIMEOUT_MS = 1000;       // Longest the connect may block the loop
+const unsigned long PROBE_RETRY_BASE_MS = 2000;    // First retry after a failed probe
+const unsigned long PROBE_RETRY_MAX_MS = 120000;   // Backoff cap while upstream stays down
+const uint8_t PROBE_FAILURES_LOST = 3;             // Failures in a row before reporting lost
+
+//----------------------------------------------------------------------------//
+// Probe State
+//----------------------------------------------------------------------------//
+
+static AppTimer g_probeTimer(PROBE_INTERVAL_MS);   // Next probe while healthy
+static AppRetry g_probeRetry(PROBE_RETRY_BASE_MS, PROBE_RETRY_MAX_MS);  // Next probe after failures
+static AppAsyncOp g_probeOp;                       // Deadline of the probe connect
+static WiFiClient g_probeClient;
+static uint8_t g_probeFailures = 0;
+static IPAddress g_probeAddress;                   // PROBE_HOST, last resolved address
+static bool g_probeResolved = false;               // g_probeAddress is valid
+static bool g_probeStale = false;                  // Look the host up again on the next connection
+static bool g_probeLookupTried = false;            // Lookup already made on this connection
+
+//----------------------------------------------------------------------------//
+// Probe Functions
+//----------------------------------------------------------------------------//
+
+/*
+ * Address to probe: the gateway, or the cached address of PROBE_HOST
+ *
+ * The host is looked up until it resolves once (at the probe backoff's
+ * pace), and again once per connection after upstream was lost, in case
+ * it moved. A failed refresh keeps the old address for later probes.
+ * @return false if PROBE_HOST has never resolved or a lookup just failed
+ */
+static bool probeAddress(IPAddress& address) {
+  if (PROBE_HOST[0] == '\0') {
+    address = WiFi.gatewayIP();
+    return true;
+  }
+  if (!g_probeResolved || (g_probeStale && !g_probeLookupTried)) {
+    g_probeLookupTried = true;
+    IPAddress resolved;
+    if (WiFi.hostByName(PROBE_HOST, resolved) != 1) {
+      return false;  // Counts as the failed probe; connecting as well would block twice
+    }
+    g_probeAddress = resolved;
+    g_probeResolved = true;
+    g_probeStale = false;
+  }
+  address = g_probeAddress;
+  return g_probeResolved;
+}
+
+/*
+ * One TCP connect to the probe address, bounded by PROBE_TIMEOUT_MS
+ */
+static bool runProbe(unsigned long now) {
+  IPAddress address;
+  if (!probeAddress(address)) {
+    return false;
+  }
+  
+  g_probeOp.start(PROBE_TIMEOUT_MS, now);
+  g_probeClient.setSocketTimeout(PROBE_TIMEOUT_MS);
+  bool connected = g_probeClient.connect(address, PROBE_PORT);
+  g_probeClient.stop();
+  
+  // The connect blocks, so check the deadline against a fresh reading
+  bool inTime = !g_probeOp.timedOut();
+  g_probeOp.finish();
+  return connected && inTime;
+}
+
+/*
+ * Verdict for a finished probe
+ */
+static Input probeFinished(bool answered, const AppState& state, unsigned long now) {
+  leaseProbed(answered);
+  
+  if (answered) {
+    g_probeFailures = 0;
+    g_probeRetry.reset();
+    g_probeTimer.start(now);
+    return state.upstreamLost ? stamp(Input::upstreamRestored(), now) : Input::none();
+  }
+  
+  // Confirm quickly, then back off while upstream stays down
+  if (g_probeFailures < 0xFF) g_probeFailures++;
+  g_probeTimer.stop();
+  g_probeRetry.schedule(now);
+  Serial.print("Reachability probe failed (");
+  Serial.print(g_probeFailures);
+  Serial.println(" in a row)");
+  
+  if (g_probeFailures == PROBE_FAILURES_LOST) {
+    g_probeStale = true;  // The host may have moved
+    if (!state.upstreamLost) {
+      return stamp(Input::upstreamLost(), now);
+    }
+  }
+  return Input::none();
+}
+
+Input pollReachability(const AppState& state, unsigned long now) {
+  // Only a connection with an address can be probed
+  if (state.mode != MODE_CONNECTED || !state.hasIP) {
+    g_probeLookupTried = false;
+    g_probeTimer.stop();
+    g_probeRetry.reset();
+    g_probeFailures = 0;
+    return Input::none();
+  }
+  
+  bool due;
+  if (g_probeRetry.isScheduled()) {
+    due = g_probeRetry.due(now);
+  } else if (g_probeTimer.isRunning()) {
+    due = g_probeTimer.expired(now);
+  } else {
+    // New connection: check at once if upstream was lost before or the
+    // address is a reused lease that may have been handed out again
+    g_probeTimer.start(now);
+    due = state.upstreamLost || leaseUnverified();
+  }
+  if (!due) {
+    return Input::none();
+  }
+  return probeFinished(runProbe(now), state, now);
+}
+
+unsigned long timeUntilProbe(unsigned long now) {
+  if (g_probeRetry.isScheduled()) {
+    return g_probeRetry.remainingTime(now);
+  }
+  return g_probeTimer.isRunning() ? g_probeTimer.remainingTime(now) : 0;
+}
+
+void seedProbeRetry(uint32_t seed) {
+  g_probeRetry.seed(seed);
+}
@@ -0,0 +1,50 @@
+#ifndef WIFI_PROBE_H
+#define WIFI_PROBE_H
+
+#include "WiFiTypes.h"
+
+//----------------------------------------------------------------------------//
+// Upstream Reachability Probe
+//----------------------------------------------------------------------------//
+
+/*
+ * WiFi.status() only knows about the link to the access point. While
+ * connected with an address, a TCP connect to a probe host checks that
+ * traffic actually gets through. Probes run every PROBE_INTERVAL_MS while
+ * they succeed; after a failure they are retried with backoff, and after
+ * PROBE_FAILURES_LOST failures in a row the upstream counts as lost.
+ *
+ * Each probe is one blocking connect bounded by PROBE_TIMEOUT_MS, so a
+ * probe stalls the loop for at most that long (a round trip while
+ * upstream works). A zero socket timeout is not used: the board core
+ * reports a connect still in progress as a failed one.
+ *
+ * The probe host is resolved once and its address cached, because DNS
+ * blocks longest exactly when upstream is down. Until the first lookup
+ * succeeds, every probe is a lookup and a failed one counts as a failed
+ * probe.
+ */
+
+/**
+ * Start, poll or finish the probe (call from readEvents every iteration)
+ * @param state Current machine state
+ * @param now Current timestamp
+ * @return INPUT_UPSTREAM_LOST or INPUT_UPSTREAM_RESTORED when the verdict
+ *         differs from state.upstreamLost, otherwise INPUT_NONE
+ */
+Input pollReachability(const AppState& state, unsigned long now);
+
+/**
+ * Time until the next probe is due (for the idle loop)
+ * @param now Current timestamp
+ * @return Milliseconds until the next probe, 0 if due now or none is planned
+ */
+unsigned long timeUntilProbe(unsigned long now);
+
+/**
+ * Seed the jitter of the probe retry backoff (see seedReconnectJitter)
+ * @param seed Per-device seed, e.g. from deviceSeed() over the MAC address
+ */
+void seedProbeRetry(uint32_t seed);
+
+#endif // WIFI_PROBE_H
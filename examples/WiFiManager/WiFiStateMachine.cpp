@@ -2,6 +2,7 @@
 #include "WiFiConnection.h"
 #include "WiFiCredentials.h"
 #include "WiFiUI.h"
+#include "WiFiMetrics.h"
 #include <WiFi.h>
 #include <MooreArduino.h>
 
@@ -31,14 +32,15 @@ using namespace MooreArduino;
 //----------------------------------------------------------------------------//
 
 extern MooreMachine<AppState, Input, Output> g_machine;  // Defined in main file
+extern AppClock g_clock;                                  // Defined in main file
 
 //----------------------------------------------------------------------------//
 // Pure State Transition Function δ: Q × Σ → Q
 //----------------------------------------------------------------------------//
 
 AppState transitionFunction(const AppState& state, const Input& input) {
-  AppState newState = state;          // Copy current state
-  newState.lastUpdate = millis();     // Update timestamp on every input
+  AppState newState = state;              // Copy current state
+  newState.lastUpdate = input.timestamp;  // Time comes from the input, never the clock
   
   switch (input.type) {
     case INPUT_NONE:
@@ -58,9 +60,23 @@ AppState transitionFunction(const AppState& state, const Input& input) {
       newState.mode = MODE_CONNECTING;              // Change to connecting state
       return newState;
       
+    case INPUT_CREDENTIALS_SAVED:
+      // Persisted - stop asking for the save effect
+      newState.credentialsChanged = false;
+      return newState;
+      
     case INPUT_CONNECTION_STARTED:
-      // WiFi.begin() was called - clear the reconnect flag
+      // WiFi.begin() was called - clear the reconnect flag and start the timeout
+      newState.shouldReconnect = false;
+      newState.attemptStartedAt = input.scanStartedAt;
+      newState.connectStartedAt = input.timestamp;
+      newState.connectTimeout = input.connectTimeout;  // Chosen by the effect layer
+      return newState;
+      
+    case INPUT_CONNECTION_FAILED:
+      // Attempt failed before WiFi.begin() - no point waiting for the timeout
       newState.shouldReconnect = false;
+      newState.mode = MODE_DISCONNECTED;
       return newState;
       
     case INPUT_RETRY_CONNECTION:
@@ -74,19 +90,82 @@ AppState transitionFunction(const AppState& state, const Input& input) {
       newState.mode = MODE_CONNECTED;           // Update mode
       newState.wifiStatus = input.wifiStatus;  // Store hardware status
       newState.shouldReconnect = false;        // Clear retry flag
+      newState.associatedAt = input.timestamp;  // DHCP phase starts now
+      newState.hasIP = false;
+      newState.linkDegraded = false;           // Fresh link, not sampled yet
+      return newState;
+      
+    case INPUT_IP_ACQUIRED:
+      // DHCP finished - the connection is fully usable
+      newState.hasIP = true;
+      return newState;
+      
+    case INPUT_LINK_DEGRADED:
+    case INPUT_LINK_RECOVERED:
+      // Link quality only has a meaning while connected
+      if (newState.mode == MODE_CONNECTED) {
+        newState.linkDegraded = (input.type == INPUT_LINK_DEGRADED);
+        newState.rssi = input.rssi;
+      }
+      return newState;
+      
+    case INPUT_ROAM_REQUESTED:
+      // Weak signal for long enough - scan for a better access point
+      if (newState.mode == MODE_CONNECTED) {
+        newState.mode = MODE_ROAMING;
+        newState.roamCheckedAt = input.timestamp;
+      }
+      return newState;
+      
+    case INPUT_ROAM_SKIPPED:
+      // Nothing clearly better around - keep the current link
+      if (newState.mode == MODE_ROAMING) {
+        newState.mode = MODE_CONNECTED;
+        newState.roamCheckedAt = input.timestamp;  // Dwell counts from the end of the scan
+      }
+      return newState;
+      
+    case INPUT_ROAM_STARTED:
+      // Reassociating - from here on it is an ordinary connection attempt
+      newState.mode = MODE_CONNECTING;
+      newState.wifiStatus = input.wifiStatus;
+      newState.shouldReconnect = false;        // WiFi.begin() was already called
+      newState.attemptStartedAt = input.scanStartedAt;
+      newState.connectStartedAt = input.timestamp;
+      newState.connectTimeout = input.connectTimeout;
+      newState.hasIP = false;
+      newState.linkDegraded = false;
+      return newState;
+      
+    case INPUT_UPSTREAM_LOST:
+      // Associated but nothing gets through: drop the link once so the
+      // reconnect path gets a fresh association and address. If upstream
+      // is still lost after that, stay connected and keep probing.
+      if (newState.mode == MODE_CONNECTED && !newState.upstreamLost) {
+        newState.mode = MODE_DISCONNECTED;
+        newState.hasIP = false;
+        newState.linkDegraded = false;
+      }
+      newState.upstreamLost = true;
+      return newState;
+      
+    case INPUT_UPSTREAM_RESTORED:
+      newState.upstreamLost = false;
       return newState;
       
     case INPUT_WIFI_DISCONNECTED:
       // Hardware reports WiFi connection lost
       newState.mode = MODE_DISCONNECTED;        // Update mode
       newState.wifiStatus = input.wifiStatus;  // Store hardware status
+      newState.hasIP = false;                  // Address is gone with the link
+      newState.linkDegraded = false;
       return newState;
       
     case INPUT_TICK: {
       // Connection timeout check (pure logic based on state)
-      if (newState.mode == MODE_CONNECTING) {
-        unsigned long currentTime = millis();
-        if (currentTime - newState.lastUpdate > 30000) { // 30 second timeout
+      // Measured from WiFi.begin(), so it only runs once the attempt has started
+      if (newState.mode == MODE_CONNECTING && !newState.shouldReconnect) {
+        if (input.timestamp - newState.connectStartedAt > newState.connectTimeout) {
           DEBUG_PRINTLN("DEBUG: Connection timeout, switching to disconnected");
           newState.mode = MODE_DISCONNECTED;
         }
@@ -116,7 +195,12 @@ Output outputFunction(const AppState& state) {
     return Output::saveCredentials();
   }
   
-  // Priority 3: Generate LED effects based on current mode
+  // Priority 3: Given up on a link the hardware still reports as up
+  if (state.mode == MODE_DISCONNECTED && state.wifiStatus == WL_CONNECTED) {
+    return Output::dropLink();
+  }
+  
+  // Priority 4: Generate LED effects based on current mode
   switch (state.mode) {
     case MODE_CONNECTED:
       return Output::updateLEDs(state.mode);
@@ -132,6 +216,9 @@ Output outputFunction(const AppState& state) {
       
     case MODE_INITIALIZING:
       return Output::updateLEDs(state.mode);
+      
+    case MODE_ROAMING:
+      return Output::roamScan();
   }
   
   return Output::none();
@@ -144,23 +231,69 @@ Output outputFunction(const AppState& state) {
 Input executeEffect(const Output& effect) {
   switch (effect.type) {
     case EFFECT_UPDATE_LEDS:
-      updateLEDs(effect.currentMode);
+      updateLEDs(effect.currentMode, g_clock.now());
       break;
       
     case EFFECT_SAVE_CREDENTIALS: {
       const AppState& state = g_machine.getState();
       saveCredentials(&state.credentials);
-      break;
+      // Return follow-up input to clear credentialsChanged (save only once)
+      return stamp(Input::credentialsSaved(), g_clock.update());
     }
     
     case EFFECT_START_WIFI_CONNECTION: {
       const AppState& state = g_machine.getState();
       Serial.println("Initiating WiFi connection...");
-      connectWiFi(&state.credentials);
-      // Return follow-up input to clear shouldReconnect flag
-      return Input::connectionStarted();
+      
+      // Scan phase (blocking), timed here since it never reaches the machine
+      unsigned long scanStartedAt = g_clock.update();
+      uint8_t bssid[6];
+      bool found = scanForNetwork(&state.credentials, bssid);
+      unsigned long scanFinishedAt = g_clock.update();
+      recordPhase(PHASE_SCAN, scanFinishedAt - scanStartedAt);
+      if (!found) {
+        // Target network not in scan: fail now instead of after the timeout
+        return stamp(Input::connectionFailed(), scanFinishedAt);
+      }
+      
+      // Associate phase: the machine times it from connectionStarted
+      unsigned long timeout = adaptiveConnectTimeout();
+      Serial.print("Connect timeout: ");
+      Serial.print(timeout);
+      Serial.println(" ms");
+      beginConnection(&state.credentials, bssid, scanFinishedAt);
+      
+      // Return follow-up input to clear shouldReconnect flag and set the
+      // timeout learned from past attempts
+      // Stamped after the blocking scan so the timeout covers only WiFi.begin()
+      return stamp(Input::connectionStarted(timeout, scanStartedAt), scanFinishedAt);
     }
     
+    case EFFECT_ROAM_SCAN: {
+      const AppState& state = g_machine.getState();
+      
+      // Scan while still connected; the old link stays up if nothing is better
+      unsigned long scanStartedAt = g_clock.update();
+      uint8_t bssid[6];
+      bool better = findStrongerAccessPoint(&state.credentials, bssid);
+      unsigned long scanFinishedAt = g_clock.update();
+      recordPhase(PHASE_SCAN, scanFinishedAt - scanStartedAt);
+      if (!better) {
+        return stamp(Input::roamSkipped(), scanFinishedAt);
+      }
+      
+      // Reassociate; the connect timeout and phase timing apply as usual
+      WiFi.disconnect();
+      unsigned long timeout = adaptiveConnectTimeout();
+      beginConnection(&state.credentials, bssid, scanFinishedAt);
+      return stamp(Input::roamStarted(timeout, scanStartedAt), scanFinishedAt);
+    }
+    
+    case EFFECT_DROP_LINK:
+      WiFi.disconnect();
+      // The link is down now; report it like the hardware would
+      return stamp(Input::wifiStatusChanged(WL_DISCONNECTED), g_clock.update());
+      
     case EFFECT_RENDER_UI:
       renderUI(effect.currentMode);
       break;
@@ -0,0 +1,147 @@
+#include "WiFiTrace.h"
+#include <MooreArduino.h>
+
+using namespace MooreArduino;
+
+//----------------------------------------------------------------------------//
+// Configuration
+//----------------------------------------------------------------------------//
+
+// Encoded bytes kept in RAM; a simulated day with 15 reconnects took 620 bytes
+const uint16_t TRACE_CAPACITY = 4096;
+
+// Bytes per printed hex line
+const uint8_t TRACE_LINE_BYTES = 32;
+
+// Record header and payload field mask
+const uint8_t TRACE_HAS_FIELDS = 0x80;     // Header bit: a field mask follows
+const uint8_t TRACE_FIELD_SSID = 0x01;
+const uint8_t TRACE_FIELD_STATUS = 0x02;
+const uint8_t TRACE_FIELD_RSSI = 0x04;
+const uint8_t TRACE_FIELD_TIMEOUT = 0x08;
+const uint8_t TRACE_FIELD_SCAN = 0x10;
+
+static_assert(INPUT_TICK < TRACE_HAS_FIELDS, "Input types must fit in 7 bits");
+
+//----------------------------------------------------------------------------//
+// Trace Storage
+//----------------------------------------------------------------------------//
+
+static TraceBuffer<TRACE_CAPACITY> g_trace;    // Repeated ticks run-length encoded
+static uint32_t g_lastRecordedAt = 0;          // Timestamp of the last recorded input
+static uint32_t g_lastDecodedAt = 0;           // Timestamp of the last decoded input
+
+//----------------------------------------------------------------------------//
+// Trace Functions
+//----------------------------------------------------------------------------//
+
+void recordInput(const Input& input) {
+  uint8_t fields = 0;
+  if (input.newCredentials.ssid[0] != '\0') fields |= TRACE_FIELD_SSID;
+  if (input.wifiStatus != 0) fields |= TRACE_FIELD_STATUS;
+  if (input.rssi != 0) fields |= TRACE_FIELD_RSSI;
+  if (input.connectTimeout != 0) fields |= TRACE_FIELD_TIMEOUT;
+  if (input.scanStartedAt != 0) fields |= TRACE_FIELD_SCAN;
+  
+  // 32-bit deltas: wrap-around of millis() is encoded like any other delta
+  uint32_t timestamp = (uint32_t)input.timestamp;
+  
+  TraceRecord record;
+  record.putByte((uint8_t)input.type | (fields ? TRACE_HAS_FIELDS : 0));
+  if (fields) record.putByte(fields);
+  record.putVarint(timestamp - g_lastRecordedAt);
+  if (fields & TRACE_FIELD_SSID) {
+    // Passwords stay out of the trace - no transition reads them
+    record.putString(input.newCredentials.ssid, sizeof(input.newCredentials.ssid) - 1);
+  }
+  if (fields & TRACE_FIELD_STATUS) record.putVarint((uint32_t)input.wifiStatus);
+  if (fields & TRACE_FIELD_RSSI) record.putSigned(input.rssi);
+  if (fields & TRACE_FIELD_TIMEOUT) record.putVarint(input.connectTimeout);
+  if (fields & TRACE_FIELD_SCAN) record.putVarint(timestamp - (uint32_t)input.scanStartedAt);
+  
+  if (g_trace.append(record)) {
+    g_lastRecordedAt = timestamp;
+  }
+}
+
+void printTrace() {
+  Serial.print("Input trace: ");
+  Serial.print(g_trace.getRecords());
+  Serial.print(" inputs in ");
+  Serial.print(g_trace.size());
+  Serial.print(" bytes, ");
+  Serial.print(g_trace.getDropped());
+  Serial.println(" dropped");
+  
+  const uint8_t* bytes = g_trace.data();
+  for (uint16_t i = 0; i < g_trace.size(); i++) {
+    if (i % TRACE_LINE_BYTES == 0) {
+      if (i > 0) Serial.println();
+      Serial.print("X ");
+    }
+    if (bytes[i] < 0x10) Serial.print("0");
+    Serial.print(bytes[i], HEX);
+  }
+  if (g_trace.size() > 0) Serial.println();
+}
+
+/*
+ * Value of one hex digit, -1 if it is none
+ */
+static int hexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+bool loadTraceLine(const char* line) {
+  if (line[0] != 'X' || line[1] != ' ') {
+    return false;
+  }
+  
+  uint8_t bytes[TRACE_LINE_BYTES];
+  uint8_t count = 0;
+  for (const char* p = line + 2; count < TRACE_LINE_BYTES; p += 2) {
+    int high = hexDigit(p[0]);
+    int low = (high < 0) ? -1 : hexDigit(p[1]);
+    if (low < 0) break;
+    bytes[count++] = (uint8_t)(high << 4 | low);
+  }
+  return count > 0 && g_trace.appendRaw(bytes, count);
+}
+
+void clearTrace() {
+  g_trace.clear();
+  g_lastRecordedAt = 0;
+  g_lastDecodedAt = 0;
+}
+
+void rewindTrace() {
+  g_trace.rewind();
+  g_lastDecodedAt = 0;
+}
+
+bool nextTracedInput(Input* input) {
+  TraceRecord record;
+  if (!g_trace.next(record)) {
+    return false;
+  }
+  
+  *input = Input();
+  uint8_t header = record.getByte();
+  uint8_t fields = (header & TRACE_HAS_FIELDS) ? record.getByte() : 0;
+  input->type = (InputType)(header & ~TRACE_HAS_FIELDS);
+  g_lastDecodedAt += record.getVarint();
+  input->timestamp = g_lastDecodedAt;
+  
+  if (fields & TRACE_FIELD_SSID) {
+    record.getString(input->newCredentials.ssid, sizeof(input->newCredentials.ssid));
+  }
+  if (fields & TRACE_FIELD_STATUS) input->wifiStatus = (int)record.getVarint();
+  if (fields & TRACE_FIELD_RSSI) input->rssi = (int)record.getSigned();
+  if (fields & TRACE_FIELD_TIMEOUT) input->connectTimeout = record.getVarint();
+  if (fields & TRACE_FIELD_SCAN) input->scanStartedAt = (uint32_t)(g_lastDecodedAt - record.getVarint());
+  
+  return record.isValid();
+}
@@ -0,0 +1,69 @@
+#ifndef WIFI_TRACE_H
+#define WIFI_TRACE_H
+
+#include "WiFiTypes.h"
+
+//----------------------------------------------------------------------------//
+// Input Trace (record on the board, replay on a PC)
+//----------------------------------------------------------------------------//
+
+/*
+ * Every input the machine steps is recorded from boot on. Since δ and λ
+ * are pure, the trace alone reproduces the board's states and effects:
+ * press 't' to print it, save the serial log, and feed it to the replay
+ * in sim/WiFiReplay.cpp. Passwords are never recorded - they do not take
+ * part in any transition.
+ *
+ * Inputs are delta-encoded into a TraceBuffer instead of being stored as
+ * ~150-byte Input structs. Record layout:
+ *   header   input type, bit 7 set if a field mask follows
+ *   mask     TRACE_FIELD_* bits of the payload fields that are not default
+ *   delta    varint, milliseconds since the previous input
+ *   fields   in mask bit order: SSID (length + chars), wifiStatus (varint),
+ *            rssi (zigzag varint), connectTimeout (varint),
+ *            scanStartedAt (varint, milliseconds before the input)
+ * A tick is 2 bytes plus the length byte, and repeated ticks with the
+ * same delta are run-length encoded, so a day of traffic takes a few KB.
+ *
+ * printTrace() prints the buffer as hex lines:
+ *   X <up to 32 bytes as hex>
+ */
+
+/**
+ * Input recorder for MooreMachine::setInputRecorder()
+ * Inputs that no longer fit are counted as dropped
+ * @param input Input about to be applied
+ */
+void recordInput(const Input& input);
+
+/**
+ * Print the encoded trace to serial as hex lines
+ */
+void printTrace();
+
+/**
+ * Append the bytes of one printed hex line to the trace (host replay)
+ * @param line Line as printed by printTrace(), with or without newline
+ * @return true if the line was a trace line and its bytes fit
+ */
+bool loadTraceLine(const char* line);
+
+/**
+ * Drop every recorded input, e.g. before loading a saved log
+ * A trace recorded after this no longer starts at boot and cannot be replayed
+ */
+void clearTrace();
+
+/**
+ * Start decoding from the first recorded input again
+ */
+void rewindTrace();
+
+/**
+ * Decode the next recorded input
+ * @param input Receives the input (password empty)
+ * @return false once all inputs have been decoded
+ */
+bool nextTracedInput(Input* input);
+
+#endif // WIFI_TRACE_H
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
+#include <MooreArduino.h>
 
 //----------------------------------------------------------------------------//
 // Hardware Configuration (extern declarations)
@@ -11,6 +12,42 @@
 extern const int power_led_pin;
 extern const int wifi_led_pin;
 
+//----------------------------------------------------------------------------//
+// Time Source
+//----------------------------------------------------------------------------//
+
+/*
+ * Every timing component in the sketch reads time through AppTimeSource.
+ * On the board this is millis(); a host build can define WIFI_VIRTUAL_TIME
+ * and drive MooreArduino::VirtualTimeSource::advance() to fast-forward
+ * through connection timeouts without waiting in real time.
+ */
+#ifdef WIFI_VIRTUAL_TIME
+typedef MooreArduino::VirtualTimeSource AppTimeSource;
+#else
+typedef MooreArduino::MillisTimeSource AppTimeSource;
+#endif
+
+typedef MooreArduino::BasicClock<AppTimeSource> AppClock;
+typedef MooreArduino::BasicTimer<AppTimeSource> AppTimer;
+typedef MooreArduino::BasicAsyncOp<AppTimeSource> AppAsyncOp;
+typedef MooreArduino::BasicInterruptButton<AppTimeSource> AppButton;
+typedef MooreArduino::BasicTicklessIdle<AppTimeSource> AppIdle;
+typedef MooreArduino::BasicGestureDetector<AppTimeSource> AppGestures;
+typedef MooreArduino::BasicRetryPolicy<AppTimeSource> AppRetry;
+typedef MooreArduino::BasicRateLimiter<AppTimeSource> AppRateLimiter;
+typedef MooreArduino::BasicCircuitBreaker<AppTimeSource> AppCircuitBreaker;
+typedef MooreArduino::BasicLinkMonitor<AppTimeSource> AppLinkMonitor;
+typedef MooreArduino::BasicStatusFilter<AppTimeSource> AppStatusFilter;
+
+//----------------------------------------------------------------------------//
+// Timing Configuration
+//----------------------------------------------------------------------------//
+
+// Connection timeout before any connect times have been learned (and upper
+// bound for the learned one, see WiFiMetrics)
+const unsigned long DEFAULT_CONNECT_TIMEOUT_MS = 30000;
+
 //----------------------------------------------------------------------------//
 // Type Definitions (Moore Machine Architecture Data Structures)
 //----------------------------------------------------------------------------//
@@ -33,12 +70,22 @@ extern const int wifi_led_pin;
  */
 enum InputType {
   INPUT_NONE,                     // No input (used as default/placeholder)
-  INPUT_RETRY_CONNECTION,         // User pressed 'r' to retry WiFi connection
+  INPUT_RETRY_CONNECTION,         // User pressed 'r' or the reconnect backoff expired
   INPUT_REQUEST_CREDENTIALS,      // User pressed 'c' to enter new WiFi credentials
   INPUT_CREDENTIALS_ENTERED,      // User finished entering SSID and password
+  INPUT_CREDENTIALS_SAVED,        // Credentials were written to flash, clear credentialsChanged
   INPUT_CONNECTION_STARTED,       // WiFi.begin() was called, reset shouldReconnect flag
+  INPUT_CONNECTION_FAILED,        // Attempt failed before WiFi.begin() (network not in scan)
   INPUT_WIFI_CONNECTED,           // Hardware detected WiFi connection established
   INPUT_WIFI_DISCONNECTED,        // Hardware detected WiFi connection lost
+  INPUT_IP_ACQUIRED,              // DHCP finished, the board has an IP address
+  INPUT_LINK_DEGRADED,            // Smoothed RSSI fell below the weak-signal threshold
+  INPUT_LINK_RECOVERED,           // Smoothed RSSI rose back above the recovery threshold
+  INPUT_ROAM_REQUESTED,           // Signal stayed weak past the dwell time, look for a better AP
+  INPUT_ROAM_SKIPPED,             // Roam scan found no clearly stronger AP, stay put
+  INPUT_ROAM_STARTED,             // Left the current AP and called WiFi.begin() again
+  INPUT_UPSTREAM_LOST,            // Reachability probe keeps failing while WiFi reports connected
+  INPUT_UPSTREAM_RESTORED,        // Reachability probe succeeded again
   INPUT_TICK                      // Timer event - check for state changes
 };
 
@@ -54,6 +101,8 @@ enum OutputType {
   EFFECT_UPDATE_LEDS,             // Update LED indicators based on current mode
   EFFECT_SAVE_CREDENTIALS,        // Persist credentials to flash storage
   EFFECT_START_WIFI_CONNECTION,   // Initiate WiFi connection attempt
+  EFFECT_ROAM_SCAN,               // Scan for a stronger AP on the same SSID
+  EFFECT_DROP_LINK,               // Disconnect a link the machine no longer trusts
   EFFECT_RENDER_UI,               // Update serial interface display
   EFFECT_LOG_CONNECTION_SUCCESS,  // Display successful connection message
   EFFECT_LOG_CONNECTION_LOST      // Display disconnection message
@@ -95,11 +144,12 @@ struct Credentials {
  * In Moore machine theory, the output (LED patterns, UI messages) depends
  * only on the current state, not on the input that caused the transition.
  * 
- * State space Q = {INITIALIZING, CONNECTING, CONNECTED, DISCONNECTED, ENTERING_CREDENTIALS}
+ * State space Q = {INITIALIZING, CONNECTING, CONNECTED, DISCONNECTED, ENTERING_CREDENTIALS, ROAMING}
  * 
  * State transitions via δ: Q × Σ → Q:
  * INITIALIZING → CONNECTING → CONNECTED ⇄ DISCONNECTED
- *                   ↓           ↗
+ *                   ↓    ↖      ⇅
+ *                   ↓     ROAMING
  *            ENTERING_CREDENTIALS
  */
 enum AppMode {
@@ -107,7 +157,8 @@ enum AppMode {
   MODE_CONNECTING,           // Attempting to connect to WiFi network
   MODE_CONNECTED,            // Successfully connected to WiFi
   MODE_DISCONNECTED,         // Not connected (initial state or lost connection)
-  MODE_ENTERING_CREDENTIALS  // User is typing SSID/password via Serial
+  MODE_ENTERING_CREDENTIALS, // User is typing SSID/password via Serial
+  MODE_ROAMING               // Connected, scanning for a stronger AP on the same SSID
 };
 
 /*
@@ -134,6 +185,15 @@ struct AppState {
   AppMode mode;                // What the application is currently doing
   int wifiStatus;              // Last known WiFi hardware status
   unsigned long lastUpdate;    // Timestamp of last state change (milliseconds)
+  unsigned long attemptStartedAt; // Timestamp the last attempt started scanning
+  unsigned long connectStartedAt; // Timestamp of the last WiFi.begin() (for timeout)
+  unsigned long associatedAt;   // Timestamp WiFi reported WL_CONNECTED
+  bool hasIP;                   // DHCP finished for the current connection
+  bool linkDegraded;            // Signal is weak on the current connection
+  int rssi;                     // Smoothed RSSI (dBm) at the last link change
+  unsigned long roamCheckedAt;  // Timestamp of the last roam scan (for the dwell time)
+  bool upstreamLost;            // Probe host unreachable (kept across reconnects until it answers)
+  unsigned long connectTimeout; // How long the current attempt may take (milliseconds)
   bool credentialsChanged;     // Flag: need to save credentials to flash
   bool shouldReconnect;        // Flag: need to call WiFi.begin()
   
@@ -142,6 +202,15 @@ struct AppState {
   AppState() : mode(MODE_INITIALIZING),           // Start in initializing mode
                wifiStatus(WL_IDLE_STATUS),        // WiFi not started yet
                lastUpdate(0),                     // No timestamp yet
+               attemptStartedAt(0),               // No connection attempt yet
+               connectStartedAt(0),
+               associatedAt(0),
+               hasIP(false),                      // No address yet
+               linkDegraded(false),               // No link yet
+               rssi(0),
+               roamCheckedAt(0),                  // Never scanned for roaming
+               upstreamLost(false),               // Assume upstream works
+               connectTimeout(DEFAULT_CONNECT_TIMEOUT_MS), // Nothing learned yet
                credentialsChanged(false),         // No changes to save
                shouldReconnect(false) {           // No connection needed yet
     // Set credential strings to empty (null-terminated)
@@ -158,6 +227,10 @@ struct AppState {
  * The transition function δ(q, σ) uses current state q and input symbol σ
  * to determine the next state q'.
  * 
+ * Every input carries the time it was captured (stamped by the input layer
+ * with MooreArduino::stamp). δ reads input.timestamp instead of millis(),
+ * so replaying the same input sequence always produces the same states.
+ * 
  * Key C++ concepts:
  * - static methods: Class methods that don't need an object instance
  * - Factory pattern: Static methods that create and return objects
@@ -168,9 +241,13 @@ struct Input {
   InputType type;                 // Which input symbol this is
   Credentials newCredentials;     // New credentials (if INPUT_CREDENTIALS_ENTERED)
   int wifiStatus;                // WiFi status code (if INPUT_WIFI_*)
+  int rssi;                      // Smoothed RSSI in dBm (if INPUT_LINK_*)
+  unsigned long connectTimeout;   // Timeout for this attempt (if INPUT_CONNECTION_STARTED)
+  unsigned long scanStartedAt;    // When this attempt's scan began (if INPUT_CONNECTION_STARTED)
+  unsigned long timestamp;        // When the event was captured (milliseconds)
   
   // Default constructor
-  Input() : type(INPUT_NONE), wifiStatus(0) {
+  Input() : type(INPUT_NONE), wifiStatus(0), rssi(0), connectTimeout(0), scanStartedAt(0), timestamp(0) {
     newCredentials.ssid[0] = '\0';
     newCredentials.pass[0] = '\0';
   }
@@ -205,9 +282,23 @@ struct Input {
     return i;
   }
   
-  static Input connectionStarted() {
+  static Input credentialsSaved() {
+    Input i;
+    i.type = INPUT_CREDENTIALS_SAVED;
+    return i;
+  }
+  
+  static Input connectionStarted(unsigned long timeoutMs, unsigned long scanStartedAt) {
     Input i;
     i.type = INPUT_CONNECTION_STARTED;
+    i.connectTimeout = timeoutMs;
+    i.scanStartedAt = scanStartedAt;
+    return i;
+  }
+  
+  static Input connectionFailed() {
+    Input i;
+    i.type = INPUT_CONNECTION_FAILED;
     return i;
   }
   
@@ -219,6 +310,59 @@ struct Input {
     return i;
   }
   
+  static Input ipAcquired() {
+    Input i;
+    i.type = INPUT_IP_ACQUIRED;
+    return i;
+  }
+  
+  static Input linkDegraded(int rssi) {
+    Input i;
+    i.type = INPUT_LINK_DEGRADED;
+    i.rssi = rssi;
+    return i;
+  }
+  
+  static Input linkRecovered(int rssi) {
+    Input i;
+    i.type = INPUT_LINK_RECOVERED;
+    i.rssi = rssi;
+    return i;
+  }
+  
+  static Input roamRequested() {
+    Input i;
+    i.type = INPUT_ROAM_REQUESTED;
+    return i;
+  }
+  
+  static Input roamSkipped() {
+    Input i;
+    i.type = INPUT_ROAM_SKIPPED;
+    return i;
+  }
+  
+  static Input roamStarted(unsigned long timeoutMs, unsigned long scanStartedAt) {
+    Input i;
+    i.type = INPUT_ROAM_STARTED;
+    i.wifiStatus = WL_DISCONNECTED;  // The old link was dropped on purpose
+    i.connectTimeout = timeoutMs;
+    i.scanStartedAt = scanStartedAt;
+    return i;
+  }
+  
+  static Input upstreamLost() {
+    Input i;
+    i.type = INPUT_UPSTREAM_LOST;
+    return i;
+  }
+  
+  static Input upstreamRestored() {
+    Input i;
+    i.type = INPUT_UPSTREAM_RESTORED;
+    return i;
+  }
+  
   static Input tick() {
     Input i;
     i.type = INPUT_TICK;
@@ -270,6 +414,18 @@ struct Output {
     return e;
   }
   
+  static Output roamScan() {
+    Output e;
+    e.type = EFFECT_ROAM_SCAN;
+    return e;
+  }
+  
+  static Output dropLink() {
+    Output e;
+    e.type = EFFECT_DROP_LINK;
+    return e;
+  }
+  
   static Output renderUI(AppMode mode) {
     Output e;
     e.type = EFFECT_RENDER_UI;
@@ -7,15 +7,16 @@
 // LED Control Functions
 //----------------------------------------------------------------------------//
 
-void updateLEDs(AppMode mode) {
+void updateLEDs(AppMode mode, unsigned long now) {
   switch (mode) {
     case MODE_CONNECTED:
-      // Solid on when connected
+    case MODE_ROAMING:
+      // Solid on when connected (still connected while scanning to roam)
       digitalWrite(wifi_led_pin, HIGH);
       break;
     case MODE_CONNECTING:
       // Blink at 2Hz during connection attempt
-      digitalWrite(wifi_led_pin, (millis() / 250) % 2);  // Toggle every 250ms
+      digitalWrite(wifi_led_pin, (now / LED_BLINK_HALF_PERIOD_MS) % 2);  // Toggle every 250ms
       break;
     default:
       // Off for all other modes (disconnected, initializing, entering credentials)
@@ -37,7 +38,7 @@ void renderUI(AppMode mode) {
       break;
     case MODE_DISCONNECTED:
       // Show retry and credential change options
-      Serial.println("Not connected. Send 'r' to retry or 'c' to change credentials.");
+      Serial.println("Not connected. Send 'r' to retry now or 'c' to change credentials.");
       break;
     case MODE_CONNECTING:
       // Simple status message during connection attempt
@@ -50,6 +51,9 @@ void renderUI(AppMode mode) {
       // Startup message
       Serial.println("Initializing...");
       break;
+    case MODE_ROAMING:
+      // Roam scan logs its own result
+      break;
   }
 }
 
@@ -107,8 +111,9 @@ char readSingleChar() {
 //----------------------------------------------------------------------------//
 
 void observeConnectedState(const AppState& oldState, const AppState& newState) {
-  // Only trigger when transitioning TO connected state
-  if (oldState.mode != MODE_CONNECTED && newState.mode == MODE_CONNECTED) {
+  // Only trigger when transitioning TO connected state (a skipped roam never left it)
+  if (oldState.mode != MODE_CONNECTED && oldState.mode != MODE_ROAMING &&
+      newState.mode == MODE_CONNECTED) {
     Serial.println("✓ Successfully connected to WiFi!");
     Serial.print("IP address: ");
     Serial.println(WiFi.localIP());
@@ -122,6 +127,24 @@ void observeDisconnectedState(const AppState& oldState, const AppState& newState
   }
 }
 
+void observeLinkQuality(const AppState& oldState, const AppState& newState) {
+  // Only report changes on the same connection (a new link starts as good)
+  if (newState.mode != MODE_CONNECTED || oldState.linkDegraded == newState.linkDegraded) {
+    return;
+  }
+  Serial.print(newState.linkDegraded ? "⚠ Weak WiFi signal: " : "✓ WiFi signal recovered: ");
+  Serial.print(newState.rssi);
+  Serial.println(" dBm");
+}
+
+void observeUpstream(const AppState& oldState, const AppState& newState) {
+  if (!oldState.upstreamLost && newState.upstreamLost) {
+    Serial.println("✗ Upstream unreachable although WiFi is connected");
+  } else if (oldState.upstreamLost && !newState.upstreamLost) {
+    Serial.println("✓ Upstream reachable again");
+  }
+}
+
 void observeCredentialChanges(const AppState& oldState, const AppState& newState) {
   // Trigger when credentialsChanged flag is set (before persistence)
   if (!oldState.credentialsChanged && newState.credentialsChanged) {
@@ -141,6 +164,7 @@ const char* getModeString(AppMode mode) {
     case MODE_CONNECTED: return "CONNECTED";                  // Successfully connected
     case MODE_DISCONNECTED: return "DISCONNECTED";            // Not connected to WiFi
     case MODE_ENTERING_CREDENTIALS: return "ENTERING_CREDENTIALS"; // User typing credentials
+    case MODE_ROAMING: return "ROAMING";                      // Scanning for a stronger AP
     default: return "UNKNOWN";                               // Invalid mode (shouldn't happen)
   }
 }
@@ -7,11 +7,14 @@
 // User Interface and Display
 //----------------------------------------------------------------------------//
 
+const unsigned long LED_BLINK_HALF_PERIOD_MS = 250;  // 2Hz blink while connecting
+
 /**
  * Update LED indicators based on current application mode
  * @param mode Current application mode
+ * @param now Timestamp captured once for this loop iteration (drives blinking)
  */
-void updateLEDs(AppMode mode);
+void updateLEDs(AppMode mode, unsigned long now);
 
 /**
  * Display appropriate UI messages based on current mode
@@ -56,6 +59,20 @@ void observeConnectedState(const AppState& oldState, const AppState& newState);
  */
 void observeDisconnectedState(const AppState& oldState, const AppState& newState);
 
+/**
+ * Observer: Report weak signal and recovery while connected
+ * @param oldState Previous state
+ * @param newState Current state
+ */
+void observeLinkQuality(const AppState& oldState, const AppState& newState);
+
+/**
+ * Observer: Report upstream loss and recovery found by the reachability probe
+ * @param oldState Previous state
+ * @param newState Current state
+ */
+void observeUpstream(const AppState& oldState, const AppState& newState);
+
 /**
  * Observer: React to credential changes
  * @param oldState Previous state
@@ -0,0 +1,273 @@
+/*
+ * Host entry point for the WiFiManager simulation
+ *
+ * Builds the unmodified sketch (setup()/loop() from WiFiManager.ino)
+ * against the simulated WiFi driver and the host Arduino core in test/host,
+ * on virtual time. See test/Makefile:
+ *
+ *   make -C test sim
+ *   test/build/wifi_sim run 24       # One office day, sketch output on stdout
+ *   test/build/wifi_sim bench        # Time-to-connect under several network conditions
+ *   test/build/wifi_sim statuscost   # Loop time spent in an expensive WiFi.status()
+ *   test/build/wifi_sim replay board.log  # Replay a trace printed by the 't' command
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <MooreArduino.h>
+#include <chrono>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "kvstore_global_api.h"
+#include "../WiFiTypes.h"
+#include "../WiFiCredentials.h"
+#include "WiFiReplay.h"
+
+using namespace MooreArduino;
+
+void setup();
+void loop();
+
+extern MooreMachine<AppState, Input, Output> g_machine;  // Defined in the sketch
+
+const unsigned long HOUR_MS = 3600000UL;
+
+//----------------------------------------------------------------------------//
+// Network Conditions
+//----------------------------------------------------------------------------//
+
+/*
+ * One scripted environment for the benchmark
+ */
+struct Condition {
+  const char* name;
+  unsigned long scanMs;
+  unsigned long associateMs;
+  unsigned long dhcpMs;
+  uint8_t jitterPercent;
+  int16_t rssi;               // Both access points, fixed
+  uint8_t rssiNoise;          // dB
+  unsigned long meanDropMs;   // Link drops that force a reconnect
+};
+
+const Condition CONDITIONS[] = {
+  // name          scan  assoc  dhcp  jitter  rssi  noise  drops
+  { "good",        2000, 1500,   500,  20,    -55,   2,    30 * 60000UL },
+  { "slow-dhcp",   2000, 1500,  4000,  20,    -55,   2,    30 * 60000UL },
+  { "congested",   4000, 4000,  1500,  60,    -65,   4,    30 * 60000UL },
+  { "weak-signal", 2500, 2500,   800,  40,    -80,   6,    15 * 60000UL },
+  { "flaky",       2000, 1500,   500,  20,    -60,   3,     5 * 60000UL },
+};
+const uint8_t CONDITION_COUNT = sizeof(CONDITIONS) / sizeof(CONDITIONS[0]);
+
+/*
+ * Two access points on one SSID, credentials already in flash
+ */
+static void buildOffice(const Condition& c) {
+  uint8_t ap1[6] = {0x02, 0, 0, 0, 0, 1};
+  uint8_t ap2[6] = {0x02, 0, 0, 0, 0, 2};
+  WiFi.sim().addAccessPoint("office", ap1, "secret", c.rssi);
+  WiFi.sim().addAccessPoint("office", ap2, "secret", c.rssi - 10);
+  WiFi.sim().setLatencies(c.scanMs, c.associateMs, c.dhcpMs);
+  WiFi.sim().setJitter(c.jitterPercent);
+  WiFi.sim().setRssiNoise(c.rssiNoise);
+  WiFi.sim().setMeanTimeBetweenDrops(c.meanDropMs);
+
+  Credentials creds;
+  strcpy(creds.ssid, "office");
+  strcpy(creds.pass, "secret");
+  saveCredentials(&creds);
+}
+
+//----------------------------------------------------------------------------//
+// Runs
+//----------------------------------------------------------------------------//
+
+/*
+ * Time-to-connect statistics collected from the machine state after each loop()
+ */
+struct ConnectStats {
+  Histogram<> online;       // Scan start → IP address
+  unsigned long connects;
+  unsigned long loops;
+  bool wasOnline;
+
+  ConnectStats() : connects(0), loops(0), wasOnline(false) {}
+
+  void sample() {
+    const AppState& state = g_machine.getState();
+    bool isOnline = state.mode == MODE_CONNECTED && state.hasIP;
+    if (isOnline && !wasOnline) {
+      online.record(state.lastUpdate - state.attemptStartedAt);
+      connects++;
+    }
+    wasOnline = isOnline;
+    loops++;
+  }
+};
+
+/*
+ * Run the sketch until `hours` of virtual time have passed
+ * @return Real time taken in milliseconds
+ */
+static double runFor(unsigned long hours, ConnectStats& stats) {
+  auto started = std::chrono::steady_clock::now();
+  setup();
+  while (VirtualTimeSource::now() < hours * HOUR_MS) {
+    loop();
+    stats.sample();
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - started;
+  return elapsed.count();
+}
+
+/*
+ * The office day: ap1 fades as the device moves away and back, random
+ * drops every few hours, and a 10 minute upstream outage at hour 5
+ */
+static int runOffice(unsigned long hours) {
+  Condition office = { "office", 2000, 1500, 500, 20, -50, 2, 3 * HOUR_MS };
+  buildOffice(office);
+  WiFiSimRssiPoint walk[] = { {0, -50}, {HOUR_MS, -84}, {2 * HOUR_MS, -50} };
+  WiFi.sim().setRssiCurve(0, walk, 3);
+
+  ConnectStats stats;
+  auto started = std::chrono::steady_clock::now();
+  setup();
+  while (VirtualTimeSource::now() < hours * HOUR_MS) {
+    unsigned long now = VirtualTimeSource::now();
+    WiFi.sim().setUpstream(!(now >= 5 * HOUR_MS && now < 5 * HOUR_MS + 600000UL));
+    loop();
+    stats.sample();
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - started;
+
+  // The sketch's own diagnostics: connect phase stats and the input trace
+  Serial.feed("s");
+  loop();
+  Serial.feed("t");
+  loop();
+
+  printf("\n== %lu h simulated in %.0f ms real time: %lu loop iterations, "
+         "%lu WiFi.status() calls, %lu associations, %lu drops, online %lu times\n",
+         hours, elapsed.count(), stats.loops, WiFi.sim().getStatusCalls(),
+         WiFi.sim().getAssociations(), WiFi.sim().getDrops(), stats.connects);
+  return 0;
+}
+
+/*
+ * One benchmark condition in a child process (the sketch's globals cannot
+ * be reset), printing one result line
+ */
+static void benchCondition(const Condition& c, unsigned long hours) {
+  Serial.setOutput(nullptr);
+  buildOffice(c);
+
+  ConnectStats stats;
+  double realMs = runFor(hours, stats);
+  printf("%-12s %8lu %8lu %8lu %8lu %10.0f\n", c.name, stats.connects,
+         stats.online.percentile(50), stats.online.percentile(90),
+         stats.online.percentile(99), realMs);
+  fflush(stdout);
+}
+
+static int runBench(unsigned long hours) {
+  printf("Time to connect (scan start to IP address) over %lu simulated hours\n", hours);
+  printf("%-12s %8s %8s %8s %8s %10s\n", "condition", "connects", "p50 ms", "p90 ms", "p99 ms", "real ms");
+  fflush(stdout);
+  for (uint8_t i = 0; i < CONDITION_COUNT; i++) {
+    pid_t child = fork();
+    if (child == 0) {
+      benchCondition(CONDITIONS[i], hours);
+      _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      fprintf(stderr, "%s: run failed\n", CONDITIONS[i].name);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/*
+ * One status-cost variant in a child process, printing one result line
+ * everyLoop adds the WiFi.status() call per loop() that readEvents made
+ * before status polling was rate-limited
+ */
+static void statusCostVariant(bool everyLoop, unsigned long hours, unsigned long costUs) {
+  Serial.setOutput(nullptr);
+  buildOffice(CONDITIONS[0]);
+  WiFi.sim().setStatusCost(costUs);
+
+  unsigned long loops = 0;
+  auto started = std::chrono::steady_clock::now();
+  setup();
+  while (VirtualTimeSource::now() < hours * HOUR_MS) {
+    if (everyLoop) WiFi.status();
+    loop();
+    loops++;
+  }
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - started;
+
+  unsigned long calls = WiFi.sim().getStatusCalls();
+  printf("%-14s %10lu %12lu %8.3f %10.0f %10.2f\n", everyLoop ? "every loop" : "rate-limited",
+         loops, calls, (double)calls / loops, elapsed.count(), elapsed.count() * 1000 / loops);
+  fflush(stdout);
+}
+
+static int runStatusCost(unsigned long hours, unsigned long costUs) {
+  printf("WiFi.status() costing %lu us, %lu simulated hours (\"good\" network)\n", costUs, hours);
+  printf("%-14s %10s %12s %8s %10s %10s\n", "polling", "loops", "status calls", "per loop",
+         "real ms", "us/loop");
+  fflush(stdout);
+  for (int everyLoop = 1; everyLoop >= 0; everyLoop--) {
+    pid_t child = fork();
+    if (child == 0) {
+      statusCostVariant(everyLoop, hours, costUs);
+      _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      fprintf(stderr, "status cost run failed\n");
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/*
+ * Replay a trace from a board's serial log; the sketch itself does not run
+ */
+static int runReplay(const char* path) {
+  FILE* log = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+  if (!log) {
+    perror(path);
+    return 1;
+  }
+  unsigned long steps = replayTrace(log, stdout);
+  if (log != stdin) fclose(log);
+  return steps > 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+  const char* mode = argc > 1 ? argv[1] : "run";
+  unsigned long hours = argc > 2 ? strtoul(argv[2], nullptr, 10) : 0;
+
+  if (strcmp(mode, "run") == 0) {
+    return runOffice(hours ? hours : 24);
+  }
+  if (strcmp(mode, "bench") == 0) {
+    return runBench(hours ? hours : 48);
+  }
+  if (strcmp(mode, "statuscost") == 0) {
+    return runStatusCost(hours ? hours : 4, argc > 3 ? strtoul(argv[3], nullptr, 10) : 50);
+  }
+  if (strcmp(mode, "replay") == 0 && argc > 2) {
+    return runReplay(argv[2]);
+  }
+  fprintf(stderr, "usage: %s run [hours] | bench [hours] | statuscost [hours] [us] | replay <serial log>\n", argv[0]);
+  return 2;
+}
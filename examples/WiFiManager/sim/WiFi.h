@@ -0,0 +1,230 @@
+#ifndef WIFI_SIM_H
+#define WIFI_SIM_H
+
+/*
+ * Simulated WiFi driver for host-side runs of the WiFiManager sketch
+ *
+ * Drop-in replacement for the board's <WiFi.h>: put this directory first
+ * on the include path, define WIFI_VIRTUAL_TIME, and compile sim/WiFiSim.cpp
+ * together with the sketch and the host Arduino core in test/host
+ * (Arduino.h, IPAddress, Serial, KVStore). `make -C test sim` does all of
+ * that and builds test/build/wifi_sim from sim/SimMain.cpp. The Arduino IDE
+ * never compiles this directory, so board builds are unaffected.
+ *
+ * The simulated world runs on MooreArduino::VirtualTimeSource:
+ * - Scripted access points (SSID, BSSID, password) with RSSI curves
+ *   (piecewise linear over virtual time, plus noise)
+ * - Scan, association and DHCP latencies with jitter; calls that block on
+ *   the board (scanNetworks, begin, blocking WiFiClient::connect) advance
+ *   virtual time themselves, DHCP completes later in the background
+ * - The link is lost when its RSSI curve falls below -90 dBm
+ * - Random link drops at a configurable mean interval
+ * - Access points and upstream that can be switched off and on
+ *
+ * Since the sketch's idle loop fast-forwards virtual time to its next
+ * deadline, hours of simulated operation take seconds of real time.
+ *
+ * Usage (host main):
+ *   uint8_t ap1[6] = {0x02, 0, 0, 0, 0, 1};
+ *   WiFiSimRssiPoint walkAway[] = { {0, -50}, {3600000, -85} };
+ *   WiFi.sim().addAccessPoint("office", ap1, "secret");
+ *   WiFi.sim().setRssiCurve(0, walkAway, 2);
+ *   WiFi.sim().setLatencies(2000, 1500, 800);
+ *   WiFi.sim().setMeanTimeBetweenDrops(3600000);
+ *   setup();
+ *   while (VirtualTimeSource::now() < 24UL * 3600000) loop();
+ */
+
+#include <Arduino.h>
+#include <MooreArduino.h>
+
+//----------------------------------------------------------------------------//
+// Status Codes (same values as the board's WiFi library)
+//----------------------------------------------------------------------------//
+
+enum {
+  WL_NO_SHIELD = 255,
+  WL_NO_MODULE = WL_NO_SHIELD,
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL,
+  WL_SCAN_COMPLETED,
+  WL_CONNECTED,
+  WL_CONNECT_FAILED,
+  WL_CONNECTION_LOST,
+  WL_DISCONNECTED
+};
+
+//----------------------------------------------------------------------------//
+// Simulation Model
+//----------------------------------------------------------------------------//
+
+const uint8_t WIFI_SIM_MAX_APS = 8;
+const uint8_t WIFI_SIM_MAX_CURVE_POINTS = 8;
+
+/*
+ * One point of an RSSI curve: signal strength at a virtual time
+ */
+struct WiFiSimRssiPoint {
+  unsigned long at;   // Virtual time (ms)
+  int16_t rssi;       // dBm
+};
+
+/*
+ * One simulated access point
+ */
+struct WiFiSimAccessPoint {
+  char ssid[33];
+  char pass[64];
+  uint8_t bssid[6];
+  uint8_t channel;
+  bool up;
+  WiFiSimRssiPoint curve[WIFI_SIM_MAX_CURVE_POINTS];
+  uint8_t curvePoints;
+};
+
+/*
+ * The simulated radio environment and driver state
+ */
+class WiFiSim {
+public:
+  WiFiSim();
+
+  // Scenario configuration
+  int addAccessPoint(const char* ssid, const uint8_t* bssid, const char* pass, int16_t rssi = -60);
+  void setRssiCurve(uint8_t ap, const WiFiSimRssiPoint* points, uint8_t count);
+  void setAccessPointUp(uint8_t ap, bool up);
+  void setLatencies(unsigned long scanMs, unsigned long associateMs, unsigned long dhcpMs);
+  void setJitter(uint8_t percent);
+  void setRssiNoise(uint8_t dB);
+  void setMeanTimeBetweenDrops(unsigned long ms);  // 0 = never drops
+  void setUpstream(bool reachable, unsigned long rttMs = 40);
+  void setDns(unsigned long latencyMs, unsigned long timeoutMs);  // Lookup time when up / down
+  void setStatusCost(unsigned long us);  // Real time each status() burns, like a driver round trip
+  void seed(uint32_t value);
+
+  // Statistics
+  unsigned long getStatusCalls() const { return statusCalls; }
+  unsigned long getAssociations() const { return associations; }
+  unsigned long getDrops() const { return drops; }
+  unsigned long getLookups() const { return lookups; }
+
+  // Driver operations used by WiFiClass / WiFiClient
+  int begin(const char* ssid, const char* pass);
+  int status();
+  int scan();
+  void disconnect();
+  void setStaticConfig(bool enabled);
+  int currentAccessPoint() const;
+  bool hasAddress();
+  bool upstreamReachable() const { return upstreamUp; }
+  int lookup(IPAddress& result);
+  unsigned long upstreamRtt() const { return rtt; }
+  int16_t rssiOf(uint8_t ap);
+  const WiFiSimAccessPoint& accessPoint(uint8_t ap) const { return aps[ap]; }
+  int scanResult(uint8_t index) const;
+  int16_t scanRssiOf(uint8_t index) const;
+
+private:
+  enum LinkPhase { LINK_IDLE, LINK_UP, LINK_NO_SSID, LINK_FAILED, LINK_LOST, LINK_DOWN };
+
+  WiFiSimAccessPoint aps[WIFI_SIM_MAX_APS];
+  uint8_t apCount;
+  int8_t scanOrder[WIFI_SIM_MAX_APS];   // Access points seen by the last scan
+  int16_t scanRssi[WIFI_SIM_MAX_APS];   // Their RSSI at scan time
+  uint8_t scanCount;
+
+  unsigned long scanLatency;
+  unsigned long associateLatency;
+  unsigned long dhcpLatency;
+  uint8_t jitterPercent;
+  uint8_t rssiNoise;
+  unsigned long meanDropInterval;
+  bool upstreamUp;
+  unsigned long rtt;
+  unsigned long dnsLatency;
+  unsigned long dnsTimeout;
+
+  LinkPhase phase;
+  int8_t ap;              // Access point associated with
+  bool staticConfig;
+  unsigned long addressAt;
+  unsigned long dropAt;
+
+  uint32_t rng;
+  unsigned long statusCost;   // us
+  unsigned long statusCalls;
+  unsigned long associations;
+  unsigned long drops;
+  unsigned long lookups;
+
+  void update();
+  unsigned long jittered(unsigned long ms);
+  uint32_t random32();
+};
+
+//----------------------------------------------------------------------------//
+// WiFi API (subset used by the sketch)
+//----------------------------------------------------------------------------//
+
+class WiFiClass {
+public:
+  WiFiClass() { memset(staticIP, 0, sizeof(staticIP)); }
+
+  int begin(const char* ssid, const char* pass);
+  int status();
+  int scanNetworks();
+  const char* SSID(uint8_t index);
+  const char* SSID();
+  int32_t RSSI(uint8_t index);
+  int32_t RSSI();
+  uint8_t* BSSID(uint8_t index, uint8_t* bssid);
+  uint8_t* BSSID(uint8_t* bssid);
+  uint8_t encryptionType();
+  IPAddress localIP();
+  IPAddress gatewayIP();
+  int hostByName(const char* host, IPAddress& result);
+  IPAddress subnetMask();
+  IPAddress dnsIP(int n = 0);
+  uint8_t* macAddress(uint8_t* mac);
+  const char* firmwareVersion();
+  void config(IPAddress local, IPAddress dns, IPAddress gateway, IPAddress subnet);
+  int disconnect();
+  void end();
+
+  /**
+   * Access the simulation to script the scenario
+   */
+  WiFiSim& sim() { return world; }
+
+private:
+  WiFiSim world;
+  uint8_t staticIP[4];
+};
+
+extern WiFiClass WiFi;
+
+/*
+ * TCP client to the simulated upstream, behaving like the Mbed-based cores
+ * connect() blocks for the round trip, or for the socket timeout when
+ * nothing answers. Connecting by name first blocks for a DNS lookup. With
+ * a socket timeout of 0 the connect is still in progress when it returns,
+ * which the core reports as a failure.
+ */
+class WiFiClient {
+public:
+  static const unsigned long DEFAULT_SOCKET_TIMEOUT_MS = 5000;
+
+  WiFiClient() : open(false), timeout(DEFAULT_SOCKET_TIMEOUT_MS) {}
+  int connect(IPAddress ip, uint16_t port);
+  int connect(const char* host, uint16_t port);
+  uint8_t connected() { return open ? 1 : 0; }
+  void stop() { open = false; }
+  void setSocketTimeout(unsigned long ms) { timeout = ms; }
+
+private:
+  bool open;
+  unsigned long timeout;
+  int attempt();
+};
+
+#endif // WIFI_SIM_H
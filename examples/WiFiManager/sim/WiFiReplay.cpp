@@ -0,0 +1,53 @@
+#include "WiFiReplay.h"
+#include "../WiFiTypes.h"
+#include "../WiFiStateMachine.h"
+#include "../WiFiTrace.h"
+#include <MooreArduino.h>
+
+using namespace MooreArduino;
+
+//----------------------------------------------------------------------------//
+// Trace Source
+//----------------------------------------------------------------------------//
+
+/*
+ * Decoded inputs of the loaded trace, as replay() expects
+ */
+struct TracedInputs {
+  bool next(Input& input) {
+    return nextTracedInput(&input);
+  }
+};
+
+//----------------------------------------------------------------------------//
+// Replay
+//----------------------------------------------------------------------------//
+
+static FILE* g_replayOut = nullptr;
+
+static void printStep(const Input& input, const AppState& state, const Output& effect) {
+  fprintf(g_replayOut, "%10lu  input=%-2d  mode=%d  wifiStatus=%-3d  effect=%d\n",
+          input.timestamp, (int)input.type, (int)state.mode, state.wifiStatus, (int)effect.type);
+}
+
+unsigned long replayTrace(FILE* in, FILE* out, AppState* finalState) {
+  MooreMachine<AppState, Input, Output> replica(transitionFunction, AppState());
+  replica.setOutputFunction(outputFunction);
+  
+  // Load every hex line of the log into the trace, skip everything else
+  char line[160];
+  while (fgets(line, sizeof(line), in)) {
+    loadTraceLine(line);
+  }
+  
+  TracedInputs inputs;
+  rewindTrace();
+  g_replayOut = out;
+  unsigned long steps = replay(replica, inputs, printStep);
+  
+  const AppState& state = replica.getState();
+  fprintf(out, "Replayed %lu inputs: mode=%d wifiStatus=%d hasIP=%d lastUpdate=%lu\n",
+          steps, (int)state.mode, state.wifiStatus, (int)state.hasIP, state.lastUpdate);
+  if (finalState) *finalState = state;
+  return steps;
+}
@@ -0,0 +1,34 @@
+#ifndef WIFI_REPLAY_H
+#define WIFI_REPLAY_H
+
+/*
+ * Host replay of an input trace recorded on the board
+ *
+ * Reads a serial log containing the output of the sketch's 't' command
+ * (other lines are skipped) and feeds the inputs through a fresh machine
+ * with the sketch's own transitionFunction and outputFunction. Effects are
+ * not executed, so this needs neither the WiFi simulation nor hardware -
+ * only the sketch sources compiled for the host.
+ *
+ * `test/build/wifi_sim replay board.log` (see SimMain.cpp) does this for a
+ * saved serial log.
+ *
+ * Usage (host main):
+ *   FILE* log = fopen("board.log", "r");
+ *   replayTrace(log, stdout);
+ */
+
+#include <stdio.h>
+
+struct AppState;
+
+/**
+ * Replay every trace line in `in`, printing one line per input to `out`:
+ * time, input type, mode and WiFi status after the input, and the effect
+ * λ produces (all as enum values)
+ * @param finalState Optional: receives the replica's state after the last input
+ * @return Number of inputs replayed
+ */
+unsigned long replayTrace(FILE* in, FILE* out, AppState* finalState = nullptr);
+
+#endif // WIFI_REPLAY_H
@@ -0,0 +1,389 @@
+#include "WiFi.h"
+#include <math.h>
+#include <chrono>
+
+using MooreArduino::VirtualTimeSource;
+
+WiFiClass WiFi;
+
+//----------------------------------------------------------------------------//
+// Simulation Constants
+//----------------------------------------------------------------------------//
+
+const int16_t SIM_RSSI_LINK_LOST = -90;   // Below this the link cannot be held
+const int16_t SIM_RSSI_VISIBLE = -95;     // Below this a scan does not see the AP
+
+//----------------------------------------------------------------------------//
+// WiFiSim - Scenario Configuration
+//----------------------------------------------------------------------------//
+
+WiFiSim::WiFiSim()
+  : apCount(0), scanCount(0), scanLatency(2000), associateLatency(1500), dhcpLatency(500),
+    jitterPercent(20), rssiNoise(2), meanDropInterval(0), upstreamUp(true), rtt(40),
+    dnsLatency(30), dnsTimeout(10000),
+    phase(LINK_IDLE), ap(-1), staticConfig(false), addressAt(0), dropAt(0),
+    rng(0x9E3779B9UL), statusCost(0), statusCalls(0), associations(0), drops(0),
+    lookups(0) {}
+
+int WiFiSim::addAccessPoint(const char* ssid, const uint8_t* bssid, const char* pass, int16_t rssi) {
+  if (apCount >= WIFI_SIM_MAX_APS) return -1;
+  WiFiSimAccessPoint& entry = aps[apCount];
+  strncpy(entry.ssid, ssid, sizeof(entry.ssid) - 1);
+  entry.ssid[sizeof(entry.ssid) - 1] = '\0';
+  strncpy(entry.pass, pass, sizeof(entry.pass) - 1);
+  entry.pass[sizeof(entry.pass) - 1] = '\0';
+  memcpy(entry.bssid, bssid, sizeof(entry.bssid));
+  entry.channel = 1 + (apCount * 5) % 11;
+  entry.up = true;
+  entry.curve[0].at = 0;
+  entry.curve[0].rssi = rssi;
+  entry.curvePoints = 1;
+  return apCount++;
+}
+
+void WiFiSim::setRssiCurve(uint8_t index, const WiFiSimRssiPoint* points, uint8_t count) {
+  if (index >= apCount || count == 0) return;
+  if (count > WIFI_SIM_MAX_CURVE_POINTS) count = WIFI_SIM_MAX_CURVE_POINTS;
+  memcpy(aps[index].curve, points, count * sizeof(WiFiSimRssiPoint));
+  aps[index].curvePoints = count;
+}
+
+void WiFiSim::setAccessPointUp(uint8_t index, bool up) {
+  if (index < apCount) aps[index].up = up;
+}
+
+void WiFiSim::setLatencies(unsigned long scanMs, unsigned long associateMs, unsigned long dhcpMs) {
+  scanLatency = scanMs;
+  associateLatency = associateMs;
+  dhcpLatency = dhcpMs;
+}
+
+void WiFiSim::setJitter(uint8_t percent) {
+  jitterPercent = percent > 100 ? 100 : percent;
+}
+
+void WiFiSim::setRssiNoise(uint8_t dB) {
+  rssiNoise = dB;
+}
+
+void WiFiSim::setMeanTimeBetweenDrops(unsigned long ms) {
+  meanDropInterval = ms;
+}
+
+void WiFiSim::setUpstream(bool reachable, unsigned long rttMs) {
+  upstreamUp = reachable;
+  rtt = rttMs;
+}
+
+void WiFiSim::setDns(unsigned long latencyMs, unsigned long timeoutMs) {
+  dnsLatency = latencyMs;
+  dnsTimeout = timeoutMs;
+}
+
+void WiFiSim::setStatusCost(unsigned long us) {
+  statusCost = us;
+}
+
+void WiFiSim::seed(uint32_t value) {
+  rng = value != 0 ? value : 1;
+}
+
+//----------------------------------------------------------------------------//
+// WiFiSim - Driver Model
+//----------------------------------------------------------------------------//
+
+int WiFiSim::begin(const char* ssid, const char* pass) {
+  // The board's driver picks the strongest access point for the SSID
+  int best = -1;
+  int16_t bestRssi = SIM_RSSI_VISIBLE;
+  for (uint8_t i = 0; i < apCount; i++) {
+    int16_t rssi = rssiOf(i);
+    if (aps[i].up && strcmp(aps[i].ssid, ssid) == 0 && rssi >= bestRssi) {
+      best = i;
+      bestRssi = rssi;
+    }
+  }
+  
+  associations++;
+  ap = best;
+  addressAt = 0;
+  if (best < 0) {
+    VirtualTimeSource::advance(jittered(associateLatency));
+    phase = LINK_NO_SSID;
+    return status();
+  }
+  
+  // Association blocks, like WiFi.begin() on the board
+  VirtualTimeSource::advance(jittered(associateLatency));
+  if (strcmp(aps[best].pass, pass) != 0 || !aps[best].up) {
+    phase = LINK_FAILED;
+    return status();
+  }
+  
+  unsigned long now = VirtualTimeSource::now();
+  phase = LINK_UP;
+  addressAt = now + (staticConfig ? 0 : jittered(dhcpLatency));
+  if (meanDropInterval > 0) {
+    // Exponentially distributed time to the next random drop
+    double u = (random32() + 1.0) / 4294967297.0;
+    dropAt = now + (unsigned long)(-log(u) * meanDropInterval);
+  }
+  return status();
+}
+
+void WiFiSim::update() {
+  if (phase != LINK_UP) return;
+  
+  unsigned long now = VirtualTimeSource::now();
+  bool randomDrop = meanDropInterval > 0 && (long)(now - dropAt) >= 0;
+  if (!aps[ap].up || rssiOf(ap) < SIM_RSSI_LINK_LOST || randomDrop) {
+    phase = LINK_LOST;
+    drops++;
+  }
+}
+
+int WiFiSim::status() {
+  statusCalls++;
+  if (statusCost > 0) {
+    // Spin in real time: virtual time only has millisecond resolution
+    auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(statusCost);
+    while (std::chrono::steady_clock::now() < until) {}
+  }
+  update();
+  switch (phase) {
+    case LINK_UP: return WL_CONNECTED;
+    case LINK_NO_SSID: return WL_NO_SSID_AVAIL;
+    case LINK_FAILED: return WL_CONNECT_FAILED;
+    case LINK_LOST: return WL_CONNECTION_LOST;
+    case LINK_DOWN: return WL_DISCONNECTED;
+    case LINK_IDLE:
+    default: return WL_IDLE_STATUS;
+  }
+}
+
+int WiFiSim::scan() {
+  VirtualTimeSource::advance(jittered(scanLatency));
+  scanCount = 0;
+  for (uint8_t i = 0; i < apCount; i++) {
+    int16_t rssi = rssiOf(i);
+    if (aps[i].up && rssi >= SIM_RSSI_VISIBLE) {
+      scanOrder[scanCount] = i;
+      scanRssi[scanCount] = rssi;
+      scanCount++;
+    }
+  }
+  return scanCount;
+}
+
+void WiFiSim::disconnect() {
+  phase = LINK_DOWN;
+  addressAt = 0;
+}
+
+void WiFiSim::setStaticConfig(bool enabled) {
+  staticConfig = enabled;
+}
+
+int WiFiSim::currentAccessPoint() const {
+  return phase == LINK_UP ? ap : -1;
+}
+
+bool WiFiSim::hasAddress() {
+  update();
+  return phase == LINK_UP && (long)(VirtualTimeSource::now() - addressAt) >= 0;
+}
+
+int WiFiSim::lookup(IPAddress& result) {
+  // No address: the stack fails at once. Otherwise the query blocks for an
+  // answer, or until the resolver gives up when nothing gets through.
+  if (!hasAddress()) return 0;
+  lookups++;
+  if (!upstreamUp) {
+    VirtualTimeSource::advance(dnsTimeout);
+    return 0;
+  }
+  VirtualTimeSource::advance(jittered(dnsLatency));
+  result = IPAddress(203, 0, 113, 1);  // Every name resolves to the one upstream host
+  return 1;
+}
+
+int16_t WiFiSim::rssiOf(uint8_t index) {
+  const WiFiSimAccessPoint& entry = aps[index];
+  unsigned long now = VirtualTimeSource::now();
+  
+  // Piecewise linear between curve points, flat beyond the ends
+  int32_t rssi = entry.curve[entry.curvePoints - 1].rssi;
+  for (uint8_t i = 0; i + 1 < entry.curvePoints; i++) {
+    const WiFiSimRssiPoint& a = entry.curve[i];
+    const WiFiSimRssiPoint& b = entry.curve[i + 1];
+    if (now < a.at) {
+      rssi = a.rssi;
+      break;
+    }
+    if (now < b.at) {
+      rssi = a.rssi + (int32_t)(b.rssi - a.rssi) * (int32_t)(now - a.at) / (int32_t)(b.at - a.at);
+      break;
+    }
+  }
+  
+  if (rssiNoise > 0) {
+    rssi += (int32_t)(random32() % (2 * rssiNoise + 1)) - rssiNoise;
+  }
+  return (int16_t)rssi;
+}
+
+int WiFiSim::scanResult(uint8_t index) const {
+  return index < scanCount ? scanOrder[index] : -1;
+}
+
+int16_t WiFiSim::scanRssiOf(uint8_t index) const {
+  return index < scanCount ? scanRssi[index] : 0;
+}
+
+unsigned long WiFiSim::jittered(unsigned long ms) {
+  if (jitterPercent == 0 || ms == 0) return ms;
+  unsigned long spread = ms * jitterPercent / 100;
+  return ms - spread + random32() % (2 * spread + 1);
+}
+
+uint32_t WiFiSim::random32() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+//----------------------------------------------------------------------------//
+// WiFiClass
+//----------------------------------------------------------------------------//
+
+int WiFiClass::begin(const char* ssid, const char* pass) {
+  return world.begin(ssid, pass);
+}
+
+int WiFiClass::status() {
+  return world.status();
+}
+
+int WiFiClass::scanNetworks() {
+  return world.scan();
+}
+
+const char* WiFiClass::SSID(uint8_t index) {
+  int entry = world.scanResult(index);
+  return entry >= 0 ? world.accessPoint(entry).ssid : "";
+}
+
+const char* WiFiClass::SSID() {
+  int entry = world.currentAccessPoint();
+  return entry >= 0 ? world.accessPoint(entry).ssid : "";
+}
+
+int32_t WiFiClass::RSSI(uint8_t index) {
+  return world.scanRssiOf(index);
+}
+
+int32_t WiFiClass::RSSI() {
+  int entry = world.currentAccessPoint();
+  return entry >= 0 ? world.rssiOf(entry) : 0;
+}
+
+uint8_t* WiFiClass::BSSID(uint8_t index, uint8_t* bssid) {
+  int entry = world.scanResult(index);
+  if (entry >= 0) memcpy(bssid, world.accessPoint(entry).bssid, 6);
+  else memset(bssid, 0, 6);
+  return bssid;
+}
+
+uint8_t* WiFiClass::BSSID(uint8_t* bssid) {
+  int entry = world.currentAccessPoint();
+  if (entry >= 0) memcpy(bssid, world.accessPoint(entry).bssid, 6);
+  else memset(bssid, 0, 6);
+  return bssid;
+}
+
+uint8_t WiFiClass::encryptionType() {
+  return 4;  // WPA2 (CCMP)
+}
+
+IPAddress WiFiClass::localIP() {
+  if (!world.hasAddress()) return IPAddress(0, 0, 0, 0);
+  if (staticIP[0] != 0) return IPAddress(staticIP[0], staticIP[1], staticIP[2], staticIP[3]);
+  return IPAddress(192, 168, 1, 100 + world.currentAccessPoint());
+}
+
+IPAddress WiFiClass::gatewayIP() {
+  return world.hasAddress() ? IPAddress(192, 168, 1, 1) : IPAddress(0, 0, 0, 0);
+}
+
+int WiFiClass::hostByName(const char*, IPAddress& result) {
+  return world.lookup(result);
+}
+
+IPAddress WiFiClass::subnetMask() {
+  return world.hasAddress() ? IPAddress(255, 255, 255, 0) : IPAddress(0, 0, 0, 0);
+}
+
+IPAddress WiFiClass::dnsIP(int) {
+  return gatewayIP();
+}
+
+uint8_t* WiFiClass::macAddress(uint8_t* mac) {
+  static const uint8_t simMac[6] = {0x02, 0x00, 0x5E, 0x00, 0x53, 0x01};
+  memcpy(mac, simMac, sizeof(simMac));
+  return mac;
+}
+
+const char* WiFiClass::firmwareVersion() {
+  return "sim";
+}
+
+void WiFiClass::config(IPAddress local, IPAddress, IPAddress, IPAddress) {
+  // An all-zero address hands addressing back to DHCP
+  for (uint8_t i = 0; i < 4; i++) {
+    staticIP[i] = local[i];
+  }
+  world.setStaticConfig(staticIP[0] != 0);
+}
+
+int WiFiClass::disconnect() {
+  world.disconnect();
+  return WL_DISCONNECTED;
+}
+
+void WiFiClass::end() {
+  world.disconnect();
+}
+
+//----------------------------------------------------------------------------//
+// WiFiClient
+//----------------------------------------------------------------------------//
+
+int WiFiClient::connect(IPAddress, uint16_t) {
+  return attempt();
+}
+
+int WiFiClient::connect(const char* host, uint16_t) {
+  IPAddress address;
+  return WiFi.hostByName(host, address) == 1 ? attempt() : 0;
+}
+
+int WiFiClient::attempt() {
+  WiFiSim& sim = WiFi.sim();
+  bool answers = sim.hasAddress() && sim.upstreamReachable();
+  open = false;
+  
+  // Zero timeout: the handshake is still in progress, which counts as failed
+  if (timeout == 0) {
+    return 0;
+  }
+  
+  // Blocks for the round trip, or until the socket timeout if nothing answers
+  if (answers && sim.upstreamRtt() <= timeout) {
+    VirtualTimeSource::advance(sim.upstreamRtt());
+    open = true;
+    return 1;
+  }
+  VirtualTimeSource::advance(timeout);
+  return 0;
+}
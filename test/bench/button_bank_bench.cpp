@@ -0,0 +1,134 @@
+/*
+ * Button panel: one ButtonBank vs one Button per pin
+ *
+ * Both variants run a 1 ms loop over the same bouncing presses and must
+ * count the same presses. Reported per variant: pin reads and host time
+ * per loop iteration. On the host digitalRead() is almost free; on a
+ * board each one costs several microseconds, and on AVR the bank reads
+ * whole port registers instead, so the read counts are the figure that
+ * carries over.
+ *
+ *   make -C test bench
+ */
+
+#include <Arduino.h>
+#include <MooreArduino.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace MooreArduino;
+
+const uint8_t FIRST_PIN = 2;
+const unsigned long RUN_MS = 10UL * 60 * 1000;  // Virtual time per variant
+
+struct PinEdge {
+  unsigned long at;
+  uint8_t pin;
+  uint8_t level;
+
+  bool operator<(const PinEdge& other) const {
+    return at < other.at;
+  }
+};
+
+struct Result {
+  unsigned long presses;
+  unsigned long reads;
+  double realMs;
+};
+
+/*
+ * Presses with 2 ms contact bounce on both edges, a different rhythm per button
+ */
+static std::vector<PinEdge> buildPresses(uint8_t buttons) {
+  std::vector<PinEdge> edges;
+  for (uint8_t i = 0; i < buttons; i++) {
+    uint8_t pin = FIRST_PIN + i;
+    unsigned long period = 700 + 53UL * i;
+    for (unsigned long t = 100 + 17UL * i; t + 200 < RUN_MS; t += period) {
+      const PinEdge press[] = {
+        {t, pin, LOW}, {t + 2, pin, HIGH}, {t + 4, pin, LOW},
+        {t + 150, pin, HIGH}, {t + 152, pin, LOW}, {t + 154, pin, HIGH}
+      };
+      edges.insert(edges.end(), press, press + 6);
+    }
+  }
+  std::stable_sort(edges.begin(), edges.end());
+  return edges;
+}
+
+/*
+ * Run a 1 ms loop; `update` polls the buttons and returns new presses
+ */
+template<typename Update>
+static Result run(const std::vector<PinEdge>& edges, Update update) {
+  Result result = {0, 0, 0};
+  size_t next = 0;
+  unsigned long readsBefore = hostDigitalReads();
+  auto started = std::chrono::steady_clock::now();
+
+  for (unsigned long now = 1; now <= RUN_MS; now++) {
+    while (next < edges.size() && edges[next].at <= now) {
+      hostSetPin(edges[next].pin, edges[next].level);
+      next++;
+    }
+    result.presses += update(now);
+  }
+
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - started;
+  result.realMs = elapsed.count();
+  result.reads = hostDigitalReads() - readsBefore;
+  return result;
+}
+
+static void report(uint8_t buttons, const char* name, const Result& r) {
+  printf("%7u %-10s %8lu %12lu %10.1f %12.1f\n", buttons, name, r.presses, r.reads,
+         r.realMs, r.realMs * 1e6 / RUN_MS);
+}
+
+static bool compare(uint8_t buttons) {
+  std::vector<PinEdge> edges = buildPresses(buttons);
+
+  std::vector<BasicButton<VirtualTimeSource> > singles;
+  for (uint8_t i = 0; i < buttons; i++) {
+    singles.push_back(BasicButton<VirtualTimeSource>(FIRST_PIN + i));
+  }
+  Result single = run(edges, [&](unsigned long now) {
+    unsigned long presses = 0;
+    for (uint8_t i = 0; i < buttons; i++) {
+      presses += singles[i].wasPressed(now);
+    }
+    return presses;
+  });
+  report(buttons, "Button[]", single);
+
+  uint8_t pins[BasicButtonBank<VirtualTimeSource>::MAX_BUTTONS];
+  for (uint8_t i = 0; i < buttons; i++) {
+    pins[i] = FIRST_PIN + i;
+  }
+  BasicButtonBank<VirtualTimeSource> bank(pins, buttons);
+  Result banked = run(edges, [&](unsigned long now) {
+    return bank.update(now) ? (unsigned long)__builtin_popcount(bank.takePressed()) : 0UL;
+  });
+  report(buttons, "ButtonBank", banked);
+
+  if (single.presses != banked.presses) {
+    printf("MISMATCH: %lu presses vs %lu\n", single.presses, banked.presses);
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  printf("1 ms loop, %lu min of virtual time\n", RUN_MS / 60000);
+  printf("%7s %-10s %8s %12s %10s %12s\n", "buttons", "variant", "presses", "pin reads",
+         "real ms", "ns per loop");
+
+  bool same = true;
+  const uint8_t sizes[] = {8, 16, 32};
+  for (uint8_t buttons : sizes) {
+    same = compare(buttons) && same;
+  }
+  return same ? 0 : 1;
+}
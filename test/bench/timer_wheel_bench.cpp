@@ -0,0 +1,130 @@
+/*
+ * 1,000 one-shot timers: TimerWheel vs polling every Timer
+ *
+ * Every timer re-arms itself with a new delay (1 ms .. 60 s) when it
+ * fires. All variants see the same delays and must fire the same timers
+ * at the same virtual times; only the work per loop iteration differs.
+ *
+ *   make -C test bench
+ */
+
+#include <Arduino.h>
+#include <MooreArduino.h>
+#include <chrono>
+#include <vector>
+
+using namespace MooreArduino;
+
+const uint16_t TIMERS = 1000;
+const unsigned long MAX_DELAY_MS = 60000;
+const unsigned long RUN_MS = 10UL * 60 * 1000;  // Virtual time per variant
+
+struct Result {
+  unsigned long iterations;
+  unsigned long fired;
+  unsigned long long checksum;  // Sum of (timer, fire time) pairs
+  double realMs;
+};
+
+static uint16_t firings[TIMERS];
+
+/*
+ * Delay of timer `index`'s n-th arming, the same for every variant
+ */
+static unsigned long delayFor(uint16_t index, uint16_t n) {
+  uint32_t x = ((uint32_t)index << 16 | n) * 0x9E3779B9UL;
+  x ^= x >> 15;
+  x *= 0x85EBCA6BUL;
+  x ^= x >> 13;
+  return 1 + x % MAX_DELAY_MS;
+}
+
+static void fire(Result& result, uint16_t index, unsigned long now) {
+  result.fired++;
+  result.checksum += (unsigned long long)(index + 1) * now;
+  firings[index]++;
+}
+
+/*
+ * The old way: every Timer checked on every 1 ms tick
+ */
+static Result runLinearScan() {
+  std::vector<BasicTimer<VirtualTimeSource> > timers(TIMERS, BasicTimer<VirtualTimeSource>(0));
+  Result result = {0, 0, 0, 0};
+  auto started = std::chrono::steady_clock::now();
+
+  for (uint16_t i = 0; i < TIMERS; i++) {
+    firings[i] = 0;
+    timers[i].setInterval(delayFor(i, 0));
+    timers[i].start(0);
+  }
+  for (unsigned long now = 1; now <= RUN_MS; now++) {
+    result.iterations++;
+    for (uint16_t i = 0; i < TIMERS; i++) {
+      if (timers[i].expired(now)) {
+        fire(result, i, now);
+        timers[i].setInterval(delayFor(i, firings[i]));
+        timers[i].start(now);
+      }
+    }
+  }
+
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - started;
+  result.realMs = elapsed.count();
+  return result;
+}
+
+/*
+ * One wheel advanced on every 1 ms tick, or straight to the next deadline
+ */
+static Result runWheel(bool tickless) {
+  static TimerWheel<uint16_t, TIMERS, VirtualTimeSource> wheel;
+  Result result = {0, 0, 0, 0};
+  auto started = std::chrono::steady_clock::now();
+
+  wheel.clear(0);
+  for (uint16_t i = 0; i < TIMERS; i++) {
+    firings[i] = 0;
+    wheel.schedule(delayFor(i, 0), i, 0);
+  }
+  unsigned long now = 0;
+  while (now < RUN_MS) {
+    now += tickless ? wheel.timeUntilDeadline(now) : 1;
+    if (now > RUN_MS) break;
+    result.iterations++;
+    wheel.advance(now);
+    uint16_t index;
+    while (wheel.pollExpired(index)) {
+      fire(result, index, now);
+      wheel.schedule(delayFor(index, firings[index]), index, now);
+    }
+  }
+
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - started;
+  result.realMs = elapsed.count();
+  return result;
+}
+
+static void report(const char* name, const Result& r) {
+  printf("%-22s %10lu %8lu %10.1f %12.1f\n", name, r.iterations, r.fired, r.realMs,
+         r.realMs * 1e6 / r.iterations);
+}
+
+int main() {
+  printf("%u timers, %lu min of virtual time\n", TIMERS, RUN_MS / 60000);
+  printf("%-22s %10s %8s %10s %12s\n", "variant", "loops", "fired", "real ms", "ns per loop");
+
+  Result linear = runLinearScan();
+  report("Timer[] scan, 1 ms", linear);
+  Result wheel = runWheel(false);
+  report("TimerWheel, 1 ms", wheel);
+  Result tickless = runWheel(true);
+  report("TimerWheel, tickless", tickless);
+
+  if (wheel.fired != linear.fired || wheel.checksum != linear.checksum ||
+      tickless.fired != linear.fired || tickless.checksum != linear.checksum) {
+    printf("MISMATCH: the variants fired different timers\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,137 @@
+#include <Arduino.h>
+#include <MooreArduino.h>
+#include <ctype.h>
+
+using MooreArduino::VirtualTimeSource;
+
+HostSerial Serial;
+
+//----------------------------------------------------------------------------//
+// Time
+//----------------------------------------------------------------------------//
+
+unsigned long millis() {
+  return VirtualTimeSource::now();
+}
+
+unsigned long micros() {
+  return VirtualTimeSource::now() * 1000UL;
+}
+
+void delay(unsigned long ms) {
+  VirtualTimeSource::advance(ms);
+}
+
+void yield() {}
+
+//----------------------------------------------------------------------------//
+// Pins and Interrupts
+//----------------------------------------------------------------------------//
+
+static int g_pins[HOST_PIN_COUNT];
+static bool g_pinsReady = false;
+static void (*g_handlers[HOST_PIN_COUNT])() = {};
+static unsigned long g_digitalReads = 0;
+
+static int& pinLevel(int pin) {
+  if (!g_pinsReady) {
+    for (int i = 0; i < HOST_PIN_COUNT; i++) g_pins[i] = HIGH;  // Pull-ups: released
+    g_pinsReady = true;
+  }
+  return g_pins[(unsigned)pin % HOST_PIN_COUNT];
+}
+
+void pinMode(int, int) {}
+
+int digitalRead(int pin) {
+  g_digitalReads++;
+  return pinLevel(pin);
+}
+
+void digitalWrite(int pin, int level) {
+  pinLevel(pin) = level;
+}
+
+int hostGetPin(int pin) {
+  return pinLevel(pin);
+}
+
+unsigned long hostDigitalReads() {
+  return g_digitalReads;
+}
+
+void hostSetPin(int pin, int level) {
+  int& current = pinLevel(pin);
+  if (current == level) return;
+  current = level;
+  void (*handler)() = g_handlers[(unsigned)pin % HOST_PIN_COUNT];
+  if (handler) handler();
+}
+
+int digitalPinToInterrupt(int pin) {
+  return pin;
+}
+
+void attachInterrupt(int interrupt, void (*handler)(), int) {
+  g_handlers[(unsigned)interrupt % HOST_PIN_COUNT] = handler;
+}
+
+void detachInterrupt(int interrupt) {
+  g_handlers[(unsigned)interrupt % HOST_PIN_COUNT] = nullptr;
+}
+
+void noInterrupts() {}
+void interrupts() {}
+
+//----------------------------------------------------------------------------//
+// String
+//----------------------------------------------------------------------------//
+
+void String::trim() {
+  size_t start = 0;
+  while (start < s.size() && isspace((unsigned char)s[start])) start++;
+  size_t end = s.size();
+  while (end > start && isspace((unsigned char)s[end - 1])) end--;
+  s = s.substr(start, end - start);
+}
+
+void String::toCharArray(char* buffer, unsigned int size) const {
+  if (size == 0) return;
+  strncpy(buffer, s.c_str(), size - 1);
+  buffer[size - 1] = '\0';
+}
+
+//----------------------------------------------------------------------------//
+// Serial
+//----------------------------------------------------------------------------//
+
+String HostSerial::readStringUntil(char terminator) {
+  std::string line;
+  while (*pending && *pending != terminator) line += *pending++;
+  if (*pending == terminator) pending++;
+  return String(line.c_str());
+}
+
+void HostSerial::print(const IPAddress& ip) {
+  char text[16];
+  snprintf(text, sizeof(text), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+  write(text);
+}
+
+void HostSerial::print(double value, int digits) {
+  char text[40];
+  snprintf(text, sizeof(text), "%.*f", digits, value);
+  write(text);
+}
+
+void HostSerial::print(long value, int base) {
+  char text[24];
+  snprintf(text, sizeof(text), base == HEX ? "%lX" : "%ld", value);
+  write(text);
+}
+
+void HostSerial::print(unsigned long value, int base) {
+  char text[24];
+  snprintf(text, sizeof(text), base == HEX ? "%lX" : "%lu", value);
+  write(text);
+}
@@ -0,0 +1,156 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/*
+ * Minimal Arduino core for host builds (tests, benchmarks, simulations)
+ *
+ * Provides just the API MooreArduino and the examples use. Time comes from
+ * MooreArduino::VirtualTimeSource: millis() returns virtual time and
+ * delay() advances it, so nothing on the host ever really waits.
+ *
+ * Pins are plain variables. hostSetPin() changes an input level and runs
+ * the interrupt handler attached to that pin, like an edge on the board.
+ * Serial writes to stdout (or nowhere, see HostSerial::setOutput) and
+ * reads from a string queued with HostSerial::feed().
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define DEC 10
+#define HEX 16
+
+const int HOST_PIN_COUNT = 64;
+
+//----------------------------------------------------------------------------//
+// Time, Pins and Interrupts
+//----------------------------------------------------------------------------//
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+void pinMode(int pin, int mode);
+int digitalRead(int pin);
+void digitalWrite(int pin, int level);
+int digitalPinToInterrupt(int pin);
+void attachInterrupt(int interrupt, void (*handler)(), int mode);
+void detachInterrupt(int interrupt);
+void noInterrupts();
+void interrupts();
+
+/**
+ * Drive an input pin from the outside; runs its interrupt handler on an edge
+ */
+void hostSetPin(int pin, int level);
+
+/**
+ * Level last written to an output pin
+ */
+int hostGetPin(int pin);
+
+/**
+ * Number of digitalRead() calls so far (benchmarks count pin reads with it)
+ */
+unsigned long hostDigitalReads();
+
+//----------------------------------------------------------------------------//
+// String and IPAddress
+//----------------------------------------------------------------------------//
+
+class String {
+public:
+  String() {}
+  String(const char* text) : s(text) {}
+  unsigned int length() const { return (unsigned int)s.size(); }
+  const char* c_str() const { return s.c_str(); }
+  void trim();
+  void toCharArray(char* buffer, unsigned int size) const;
+
+private:
+  std::string s;
+};
+
+class IPAddress {
+public:
+  IPAddress() { memset(bytes, 0, sizeof(bytes)); }
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    bytes[0] = a; bytes[1] = b; bytes[2] = c; bytes[3] = d;
+  }
+  IPAddress(uint32_t value) { memcpy(bytes, &value, sizeof(bytes)); }
+  uint8_t operator[](int i) const { return bytes[i]; }
+  uint8_t& operator[](int i) { return bytes[i]; }
+  operator uint32_t() const { uint32_t v; memcpy(&v, bytes, sizeof(v)); return v; }
+  bool operator==(const IPAddress& other) const { return memcmp(bytes, other.bytes, 4) == 0; }
+
+private:
+  uint8_t bytes[4];
+};
+
+//----------------------------------------------------------------------------//
+// Serial
+//----------------------------------------------------------------------------//
+
+class HostSerial {
+public:
+  HostSerial() : out(stdout), pending("") {}
+
+  void begin(unsigned long) {}
+  operator bool() const { return true; }
+  void flush() {}
+
+  int available() const { return *pending ? 1 : 0; }
+  int read() { return *pending ? *pending++ : -1; }
+  String readStringUntil(char terminator);
+
+  void print(const char* text) { write(text); }
+  void print(const String& text) { write(text.c_str()); }
+  void print(char c) { char t[2] = {c, '\0'}; write(t); }
+  void print(const IPAddress& ip);
+  void print(double value, int digits = 2);
+  void print(int value, int base = DEC) { print((long)value, base); }
+  void print(unsigned int value, int base = DEC) { print((unsigned long)value, base); }
+  void print(long value, int base = DEC);
+  void print(unsigned long value, int base = DEC);
+  void print(unsigned char value, int base = DEC) { print((unsigned long)value, base); }
+  void print(long long value, int base = DEC) { print((long)value, base); }
+  void print(unsigned long long value, int base = DEC) { print((unsigned long)value, base); }
+
+  template<typename T> void println(T value) { print(value); write("\n"); }
+  template<typename T> void println(T value, int base) { print(value, base); write("\n"); }
+  void println() { write("\n"); }
+
+  /**
+   * Send output to a file instead of stdout (nullptr discards it)
+   */
+  void setOutput(FILE* file) { out = file; }
+
+  /**
+   * Queue characters for available()/read(); the string must stay alive
+   */
+  void feed(const char* text) { pending = text; }
+
+private:
+  FILE* out;
+  const char* pending;
+
+  void write(const char* text) { if (out) fputs(text, out); }
+};
+
+extern HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
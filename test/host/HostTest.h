@@ -0,0 +1,60 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+/*
+ * Minimal checks for the host tests
+ *
+ * CHECK() reports a failed condition with its location and keeps going;
+ * main() ends with `return testResult();`, which prints a summary and
+ * yields the process exit code make looks at.
+ *
+ * Usage:
+ *   int main() {
+ *     CHECK(timer.expired());
+ *     CHECK_EQUAL(state.mode, MODE_CONNECTED);
+ *     return testResult();
+ *   }
+ */
+
+#include <stdio.h>
+
+struct HostTestCounts {
+  unsigned long checks;
+  unsigned long failures;
+};
+
+inline HostTestCounts& testCounts() {
+  static HostTestCounts counts = {0, 0};
+  return counts;
+}
+
+inline bool testCheck(bool passed, const char* expression, const char* file, int line) {
+  testCounts().checks++;
+  if (!passed) {
+    testCounts().failures++;
+    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+  }
+  return passed;
+}
+
+template<typename A, typename B>
+inline bool testCheckEqual(const A& actual, const B& expected, const char* expression,
+                           const char* file, int line) {
+  bool passed = testCheck(actual == expected, expression, file, line);
+  if (!passed) {
+    fprintf(stderr, "    actual:   %lld\n    expected: %lld\n", (long long)actual, (long long)expected);
+  }
+  return passed;
+}
+
+inline int testResult() {
+  const HostTestCounts& counts = testCounts();
+  fprintf(stderr, "%lu checks, %lu failed\n", counts.checks, counts.failures);
+  return counts.failures == 0 ? 0 : 1;
+}
+
+#define CHECK(condition) testCheck((condition), #condition, __FILE__, __LINE__)
+#define CHECK_EQUAL(actual, expected) \
+  testCheckEqual((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
+
+#endif // HOST_TEST_H
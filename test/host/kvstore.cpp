@@ -0,0 +1,42 @@
+#include "kvstore_global_api.h"
+#include "mbed_error.h"
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+static std::map<std::string, std::vector<uint8_t> >& store() {
+  static std::map<std::string, std::vector<uint8_t> > entries;
+  return entries;
+}
+
+int kv_set(const char* key, const void* buffer, size_t size, uint32_t) {
+  const uint8_t* bytes = (const uint8_t*)buffer;
+  store()[key] = std::vector<uint8_t>(bytes, bytes + size);
+  return MBED_SUCCESS;
+}
+
+int kv_get(const char* key, void* buffer, size_t bufferSize, size_t* actualSize) {
+  auto entry = store().find(key);
+  if (entry == store().end()) return MBED_ERROR_ITEM_NOT_FOUND;
+  size_t n = entry->second.size() < bufferSize ? entry->second.size() : bufferSize;
+  memcpy(buffer, entry->second.data(), n);
+  if (actualSize) *actualSize = n;
+  return MBED_SUCCESS;
+}
+
+int kv_get_info(const char* key, kv_info_t* info) {
+  auto entry = store().find(key);
+  if (entry == store().end()) return MBED_ERROR_ITEM_NOT_FOUND;
+  info->size = entry->second.size();
+  info->flags = 0;
+  return MBED_SUCCESS;
+}
+
+int kv_remove(const char* key) {
+  return store().erase(key) ? MBED_SUCCESS : MBED_ERROR_ITEM_NOT_FOUND;
+}
+
+void hostKvClear() {
+  store().clear();
+}
@@ -0,0 +1,27 @@
+#ifndef HOST_KVSTORE_GLOBAL_API_H
+#define HOST_KVSTORE_GLOBAL_API_H
+
+/*
+ * In-memory stand-in for the Mbed KVStore global API (host builds)
+ * Contents live until hostKvClear() or the end of the process.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+  size_t size;
+  uint32_t flags;
+} kv_info_t;
+
+int kv_set(const char* key, const void* buffer, size_t size, uint32_t flags);
+int kv_get(const char* key, void* buffer, size_t bufferSize, size_t* actualSize);
+int kv_get_info(const char* key, kv_info_t* info);
+int kv_remove(const char* key);
+
+/**
+ * Forget every stored key (a factory-fresh board)
+ */
+void hostKvClear();
+
+#endif // HOST_KVSTORE_GLOBAL_API_H
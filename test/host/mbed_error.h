@@ -0,0 +1,8 @@
+#ifndef HOST_MBED_ERROR_H
+#define HOST_MBED_ERROR_H
+
+// Status codes returned by the host KVStore stand-in
+#define MBED_SUCCESS 0
+#define MBED_ERROR_ITEM_NOT_FOUND (-0x80FF0107)
+
+#endif // HOST_MBED_ERROR_H
@@ -0,0 +1,168 @@
+/*
+ * AsyncOpPool: deadline order under interleaved finish(), stale handles,
+ * a full pool, generation wrap, and deadlines across the 32-bit wrap
+ */
+
+#include <Arduino.h>
+#include <MooreArduino.h>
+#include "HostTest.h"
+
+using namespace MooreArduino;
+
+/*
+ * millis() as it is on the boards: 32 bits, wrapping every 49.7 days
+ */
+struct Millis32TimeSource {
+  typedef uint32_t time_type;
+  static uint32_t now() { return (uint32_t)VirtualTimeSource::now(); }
+  static void idle(unsigned long maxMs) { VirtualTimeSource::idle(maxMs); }
+  static void wake() {}
+};
+
+typedef AsyncOpPool<uint16_t, 16, Millis32TimeSource> Pool;
+
+static uint32_t rng = 0x12345678;
+
+static uint32_t random32() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+/*
+ * Start and finish operations at random, then drain: every operation still
+ * in flight must come out exactly once, in deadline order
+ */
+static void checkOrder(uint32_t base) {
+  Pool pool;
+  Handle handles[16];
+  uint32_t deadlines[16];
+  bool active[16] = {};
+
+  for (int round = 0; round < 200; round++) {
+    uint16_t id = random32() % 16;
+    if (active[id]) {
+      CHECK(pool.finish(handles[id]));
+      active[id] = false;
+    } else {
+      uint32_t start = base + random32() % 1000;
+      uint32_t timeout = random32() % 5000;
+      handles[id] = pool.start(timeout, id, start);
+      CHECK(handles[id].isValid());
+      deadlines[id] = start + timeout;
+      active[id] = true;
+    }
+  }
+
+  uint16_t inFlight = 0;
+  for (int i = 0; i < 16; i++) inFlight += active[i];
+  CHECK_EQUAL(pool.size(), inFlight);
+
+  uint16_t id;
+  uint32_t last = base;
+  uint16_t drained = 0;
+  while (pool.pollExpired(base + 10000, id)) {
+    CHECK(active[id]);
+    CHECK((int32_t)(deadlines[id] - last) >= 0);
+    last = deadlines[id];
+    active[id] = false;
+    drained++;
+  }
+  CHECK_EQUAL(drained, inFlight);
+  CHECK(pool.isEmpty());
+}
+
+int main() {
+  // Deadline order with finish() from the middle of the heap
+  checkOrder(1000);
+  checkOrder(0xFFFFF000UL);  // Starts and deadlines on both sides of the wrap
+
+  // Left subtree 20..26, right subtree 2..8: removing 23 moves 8 under 21,
+  // so it must sift up past 21 and 20. Later starts keep it off the tail.
+  Pool heap;
+  const uint16_t byPosition[] = {1, 20, 2, 21, 22, 3, 4, 23, 24, 25, 26, 5, 6, 7, 8};
+  Handle removed;
+  for (int i = 0; i < 15; i++) {
+    Handle handle = heap.start(byPosition[i], byPosition[i], 0);
+    if (byPosition[i] == 23) removed = handle;
+  }
+  CHECK(heap.finish(removed));
+  for (uint16_t late = 30; late < 32; late++) {
+    heap.start(late, late, 0);
+  }
+  const uint16_t drainOrder[] = {1, 2, 3, 4, 5, 6, 7, 8, 20, 21, 22, 24, 25, 26, 30, 31};
+  uint16_t payload;
+  for (int i = 0; i < 8; i++) {
+    CHECK(heap.pollExpired(9, payload));  // 8 is due by now, though it sat under 20
+    CHECK_EQUAL(payload, drainOrder[i]);
+  }
+  CHECK(!heap.pollExpired(9, payload));
+  for (int i = 8; i < 16; i++) {
+    CHECK(heap.pollExpired(100, payload));
+    CHECK_EQUAL(payload, drainOrder[i]);
+  }
+  CHECK(heap.isEmpty());
+
+  // Stale handles: finished, timed out, and a reused slot
+  AsyncOpPool<uint16_t, 2, Millis32TimeSource> small;
+  Handle a = small.start(100, 1, 0);
+  CHECK(small.finish(a));
+  CHECK(!small.finish(a));
+  Handle b = small.start(100, 2, 0);
+  CHECK_EQUAL(b.index, a.index);  // Same slot, new generation
+  CHECK(!small.finish(a));
+  CHECK(small.isActive(b));
+  CHECK(!small.pollExpired(100, payload));
+  CHECK(small.pollExpired(101, payload));
+  CHECK_EQUAL(payload, 2);
+  CHECK(!small.finish(b));
+  CHECK(!small.finish(Handle()));
+
+  // A full pool hands out an invalid handle and keeps what it has
+  Handle first = small.start(10, 1, 0);
+  Handle second = small.start(20, 2, 0);
+  Handle third = small.start(5, 3, 0);
+  CHECK(first.isValid() && second.isValid());
+  CHECK(!third.isValid());
+  CHECK_EQUAL(small.size(), 2);
+  CHECK(small.pollExpired(11, payload));
+  CHECK_EQUAL(payload, 1);
+  CHECK(small.start(5, 3, 11).isValid());
+
+  // Generation wrap on one slot: never 0, and the previous handle is always stale
+  AsyncOpPool<uint16_t, 2, Millis32TimeSource> single;  // Freed slots are reused first
+  Handle previous = single.start(10, 0, 0);
+  single.finish(previous);
+  bool generationsOk = true;
+  for (unsigned long i = 0; i < 70000; i++) {
+    Handle next = single.start(10, 0, 0);
+    generationsOk = generationsOk && next.index == previous.index && next.generation != 0 &&
+                    !single.isActive(previous) && single.isActive(next) && single.finish(next);
+    previous = next;
+  }
+  CHECK(generationsOk);
+
+  // Deadlines straddling the 32-bit wrap
+  Pool pool;
+  pool.start(0x200, 1, 0xFFFFFF00UL);  // Due at 0x100, after the wrap
+  pool.start(0x10, 2, 0xFFFFFF80UL);   // Due at 0xFFFFFF90, before it
+  pool.start(0x50, 3, 0x10);           // Started after the wrap, due at 0x60
+  uint32_t deadline = 0;
+  CHECK(pool.nextDeadline(deadline));
+  CHECK_EQUAL(deadline, 0xFFFFFF91UL);
+  CHECK_EQUAL(pool.timeUntilDeadline(0xFFFFFF81UL), 0x10UL);
+  CHECK(!pool.pollExpired(0xFFFFFF90UL, payload));
+  CHECK(pool.pollExpired(0xFFFFFF91UL, payload));
+  CHECK_EQUAL(payload, 2);
+  CHECK(!pool.pollExpired(0x60, payload));
+  CHECK_EQUAL(pool.timeUntilDeadline(0x60), 1UL);
+  CHECK(pool.pollExpired(0x61, payload));
+  CHECK_EQUAL(payload, 3);
+  CHECK(!pool.pollExpired(0x100, payload));
+  CHECK(pool.pollExpired(0x101, payload));
+  CHECK_EQUAL(payload, 1);
+  CHECK_EQUAL(pool.timeUntilDeadline(0x101), 0xFFFFFFFFUL);
+
+  return testResult();
+}
@@ -0,0 +1,106 @@
+/*
+ * GestureDetector fed with InterruptButton edges
+ *
+ * Every gesture here happens while loop() is blocked: the edges only
+ * reach the detector at the next iteration, long after they happened.
+ */
+
+#include <Arduino.h>
+#include <MooreArduino.h>
+#include "HostTest.h"
+
+using namespace MooreArduino;
+
+const int PIN = 4;
+
+typedef BasicInterruptButton<VirtualTimeSource> VirtualButton;
+
+VirtualButton button(PIN);
+
+void onButtonEdge() {
+  button.onEdge();
+}
+
+static void edgeAt(unsigned long at, int level) {
+  VirtualTimeSource::set(at);
+  hostSetPin(PIN, level);
+}
+
+/*
+ * One loop iteration the way WiFiManager's readEvents does it
+ */
+static GestureType iteration(BasicGestureDetector<VirtualTimeSource>& gestures, unsigned long now) {
+  VirtualTimeSource::set(now);
+  button.update(now);
+  GestureType gesture = GESTURE_NONE;
+  bool pressed;
+  VirtualButton::time_type at;
+  while (gesture == GESTURE_NONE && button.nextEdge(pressed, at)) {
+    gesture = pressed ? gestures.press(at) : gestures.release(at);
+  }
+  return gesture != GESTURE_NONE ? gesture : gestures.poll(now);
+}
+
+int main() {
+  button.begin(onButtonEdge);
+
+  // Sampling the level once per iteration misses a click made while blocked
+  BasicGestureDetector<VirtualTimeSource> sampled;
+  edgeAt(1000, LOW);
+  edgeAt(1150, HIGH);
+  VirtualTimeSource::set(4000);
+  button.update(4000);
+  CHECK_EQUAL(sampled.update(button.isPressed(), 4000), GESTURE_NONE);
+  CHECK_EQUAL(sampled.update(button.isPressed(), 5000), GESTURE_NONE);
+  bool pressed;
+  VirtualButton::time_type at;
+  while (button.nextEdge(pressed, at)) {}
+
+  // Both edges of a click inside one blocked iteration
+  BasicGestureDetector<VirtualTimeSource> gestures;
+  edgeAt(10000, LOW);
+  edgeAt(10150, HIGH);
+  CHECK_EQUAL(iteration(gestures, 13000), GESTURE_CLICK);  // Double-click gap long over
+  CHECK_EQUAL(gestures.getGestureTime(), 10150UL + 300 + 1);
+  CHECK_EQUAL(iteration(gestures, 13050), GESTURE_NONE);
+
+  // A double click inside one blocked iteration
+  edgeAt(20000, LOW);
+  edgeAt(20100, HIGH);
+  edgeAt(20250, LOW);
+  edgeAt(20350, HIGH);
+  CHECK_EQUAL(iteration(gestures, 23000), GESTURE_DOUBLE_CLICK);
+  CHECK_EQUAL(gestures.getGestureTime(), 20250UL);
+  CHECK_EQUAL(iteration(gestures, 23050), GESTURE_NONE);
+
+  // A long press pressed and released inside one blocked iteration
+  edgeAt(30000, LOW);
+  edgeAt(31500, HIGH);
+  CHECK_EQUAL(iteration(gestures, 34000), GESTURE_LONG_PRESS);
+  CHECK_EQUAL(gestures.getGestureTime(), 30000UL + 800);
+  CHECK_EQUAL(iteration(gestures, 34050), GESTURE_NONE);
+
+  // Two clicks far apart, both inside one blocked iteration: one gesture per
+  // iteration, the second one comes from the edges left in the queue
+  edgeAt(40000, LOW);
+  edgeAt(40100, HIGH);
+  edgeAt(41000, LOW);
+  edgeAt(41100, HIGH);
+  CHECK_EQUAL(iteration(gestures, 45000), GESTURE_CLICK);
+  CHECK_EQUAL(gestures.getGestureTime(), 40100UL + 300 + 1);
+  CHECK(button.hasEdges());
+  CHECK_EQUAL(iteration(gestures, 45000), GESTURE_CLICK);
+  CHECK_EQUAL(gestures.getGestureTime(), 41100UL + 300 + 1);
+  CHECK(!button.hasEdges());
+
+  // Polled in time, a held button still reports the long press on schedule
+  edgeAt(50000, LOW);
+  CHECK_EQUAL(iteration(gestures, 50100), GESTURE_NONE);
+  CHECK_EQUAL(gestures.timeUntilDeadline(50100), 700UL);
+  CHECK_EQUAL(iteration(gestures, 50800), GESTURE_LONG_PRESS);
+  CHECK_EQUAL(gestures.getGestureTime(), 50800UL);
+  edgeAt(51000, HIGH);
+  CHECK_EQUAL(iteration(gestures, 51100), GESTURE_NONE);
+
+  return testResult();
+}
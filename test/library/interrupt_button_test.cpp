@@ -0,0 +1,75 @@
+/*
+ * InterruptButton: debounced edges keep the time they happened
+ */
+
+#include <Arduino.h>
+#include <MooreArduino.h>
+#include "HostTest.h"
+
+using namespace MooreArduino;
+
+const int PIN = 4;
+
+typedef BasicInterruptButton<VirtualTimeSource> VirtualButton;
+
+VirtualButton button(PIN);
+
+void onButtonEdge() {
+  button.onEdge();
+}
+
+/*
+ * Drive the pin at an absolute virtual time, like an edge during a blocked loop
+ */
+static void edgeAt(unsigned long at, int level) {
+  VirtualTimeSource::set(at);
+  hostSetPin(PIN, level);
+}
+
+int main() {
+  bool pressed;
+  VirtualButton::time_type at;
+
+  button.begin(onButtonEdge);
+  CHECK(!button.update(0));
+  CHECK(!button.nextEdge(pressed, at));
+
+  // A bouncing click that starts and ends while loop() is blocked
+  edgeAt(1000, LOW);
+  edgeAt(1003, HIGH);  // Bounce
+  edgeAt(1005, LOW);
+  edgeAt(1180, HIGH);
+  edgeAt(1182, LOW);   // Bounce
+  edgeAt(1184, HIGH);
+  VirtualTimeSource::set(4000);
+
+  CHECK(button.update(4000));
+  CHECK(!button.isPressed());
+  CHECK(button.hasEdges());
+  CHECK(button.nextEdge(pressed, at));
+  CHECK(pressed);
+  CHECK_EQUAL(at, 1005UL);
+  CHECK(button.nextEdge(pressed, at));
+  CHECK(!pressed);
+  CHECK_EQUAL(at, 1184UL);
+  CHECK(!button.nextEdge(pressed, at));
+  CHECK(!button.hasEdges());
+
+  // The press is still counted for wasPressed() users
+  CHECK(button.wasPressed(4000));
+  CHECK_EQUAL(button.getLastPressTime(), 1005UL);
+  CHECK(!button.wasPressed(4000));
+
+  // Nobody takes the edges: the oldest are kept, the rest counted
+  for (unsigned long i = 0; i < 20; i++) {
+    edgeAt(5000 + i * 200, LOW);
+    edgeAt(5100 + i * 200, HIGH);
+    button.update(5160 + i * 200);  // Past the release debounce
+  }
+  CHECK(button.nextEdge(pressed, at));
+  CHECK(pressed);
+  CHECK_EQUAL(at, 5000UL);
+  CHECK_EQUAL(button.getDroppedEdges(), 40UL - 16UL);
+
+  return testResult();
+}
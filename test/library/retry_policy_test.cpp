@@ -0,0 +1,38 @@
+/*
+ * RetryPolicy: every drawn delay stays within [base, max]
+ */
+
+#include <Arduino.h>
+#include <MooreArduino.h>
+#include "HostTest.h"
+
+using namespace MooreArduino;
+
+int main() {
+  BasicRetryPolicy<VirtualTimeSource> retry(100, 60000);
+  retry.seed(12345);
+  for (int i = 0; i < 50; i++) {
+    CHECK(retry.schedule(0));
+    CHECK(retry.getLastDelay() >= 100);
+    CHECK(retry.getLastDelay() <= 60000);
+  }
+
+  // Base raised above 3 × the last delay without a reset()
+  retry.reset();
+  retry.schedule(0);
+  CHECK(retry.getLastDelay() < 1000);
+  retry.setBaseDelay(10000);
+  for (int i = 0; i < 50; i++) {
+    CHECK(retry.schedule(0));
+    CHECK(retry.getLastDelay() >= 10000);
+    CHECK(retry.getLastDelay() <= 60000);
+  }
+
+  // Base raised to the cap: the only delay left is the base
+  retry.setBaseDelay(60000);
+  CHECK(retry.schedule(0));
+  CHECK_EQUAL(retry.getLastDelay(), 60000UL);
+  CHECK_EQUAL(retry.remainingTime(0), 60000UL);
+
+  return testResult();
+}
@@ -0,0 +1,66 @@
+/*
+ * Periodic Timer: restart() keeps the phase whether it is called late,
+ * on time or early, and counts only ticks that were really missed
+ */
+
+#include <Arduino.h>
+#include <MooreArduino.h>
+#include "HostTest.h"
+
+using namespace MooreArduino;
+
+/*
+ * millis() as it is on the boards: 32 bits, wrapping every 49.7 days
+ */
+struct Millis32TimeSource {
+  typedef uint32_t time_type;
+  static uint32_t now() { return (uint32_t)VirtualTimeSource::now(); }
+  static void idle(unsigned long maxMs) { VirtualTimeSource::idle(maxMs); }
+  static void wake() {}
+};
+
+int main() {
+  // On time, then late by two and a half periods
+  BasicTimer<VirtualTimeSource> tick(100);
+  tick.setPeriodic(CATCHUP_REPORT);
+  tick.start(1000);
+  CHECK(tick.expired(1100));
+  tick.restart(1100);
+  CHECK_EQUAL(tick.getMissed(), 0UL);
+  CHECK_EQUAL(tick.remainingTime(1100), 100UL);
+  tick.restart(1450);  // Due at 1200: 1300 and 1400 were missed
+  CHECK_EQUAL(tick.getMissed(), 2UL);
+  CHECK_EQUAL(tick.remainingTime(1450), 50UL);
+
+  // Early: the deadline moves one period on, nothing counts as missed
+  tick.restart(1460);  // Due at 1500, restarted 40 ms before it
+  CHECK_EQUAL(tick.takeMissed(), 2UL);
+  CHECK_EQUAL(tick.remainingTime(1460), 140UL);
+  CHECK(!tick.expired(1599));
+  CHECK(tick.expired(1600));
+  tick.restart(1600);
+  CHECK_EQUAL(tick.getMissed(), 0UL);
+  CHECK_EQUAL(tick.remainingTime(1600), 100UL);
+
+  // Early with CATCHUP_SKIP keeps the phase too
+  BasicTimer<VirtualTimeSource> skip(100);
+  skip.setPeriodic(CATCHUP_SKIP);
+  skip.start(0);
+  skip.restart(10);
+  CHECK_EQUAL(skip.remainingTime(10), 190UL);
+  skip.restart(650);  // Due at 200: skips to the tick at 600
+  CHECK_EQUAL(skip.remainingTime(650), 50UL);
+
+  // Across the 32-bit wrap, early and late
+  BasicTimer<Millis32TimeSource> wrapped(100);
+  wrapped.setPeriodic(CATCHUP_REPORT);
+  wrapped.start(0xFFFFFF00UL);
+  wrapped.restart(0xFFFFFF10UL);  // Early: due at 0xFFFFFF64, now next at 0xFFFFFFC8
+  CHECK_EQUAL(wrapped.getMissed(), 0UL);
+  CHECK_EQUAL(wrapped.remainingTime(0xFFFFFF10UL), 0xB8UL);
+  wrapped.restart(0x150);  // Due at 0xFFFFFFC8: 0x2C, 0x90 and 0xF4 were missed
+  CHECK_EQUAL(wrapped.getMissed(), 3UL);
+  CHECK_EQUAL(wrapped.remainingTime(0x150), 8UL);
+
+  return testResult();
+}
@@ -0,0 +1,119 @@
+/*
+ * 64-bit time: WideTimeSource across many 32-bit wraps, and Timer,
+ * AsyncOp, Button and TimerWheel across the (theoretical) 64-bit rollover
+ */
+
+#include <Arduino.h>
+#include <MooreArduino.h>
+#include "HostTest.h"
+
+using namespace MooreArduino;
+
+typedef WideTimeSource<VirtualTimeSource> Virtual64;
+
+const uint64_t WRAP = 0x100000000ULL;
+const uint64_t DAY_MS = 24ULL * 3600 * 1000;
+const uint64_t MAX64 = ~(uint64_t)0;
+const uint32_t PROGRESS_ONE = BasicAsyncOp<Virtual64>::PROGRESS_ONE;
+
+int main() {
+  // Quarter-wrap steps: the low word wraps every 4th step
+  uint64_t expected = 0;
+  for (int i = 0; i < 12; i++) {
+    VirtualTimeSource::advance(0x40000000UL);
+    expected += 0x40000000ULL;
+    CHECK_EQUAL(Virtual64::now(), expected);
+  }
+  CHECK_EQUAL(Virtual64::now(), 3 * WRAP);
+
+  // Steps just short of a full wrap still count one wrap each
+  for (int i = 0; i < 5; i++) {
+    VirtualTimeSource::advance(0xFFFFFFFFUL);
+    expected += 0xFFFFFFFFULL;
+    CHECK_EQUAL(Virtual64::now(), expected);
+  }
+
+  // A 90-day timer spans two wraps of millis()
+  BasicTimer<Virtual64> maintenance(90 * DAY_MS);
+  maintenance.start(Virtual64::now());
+  uint64_t started = Virtual64::now();
+  while (Virtual64::now() - started + 0x40000000ULL < 90 * DAY_MS) {
+    VirtualTimeSource::advance(0x40000000UL);
+    Virtual64::now();
+    CHECK(!maintenance.expired(Virtual64::now()));
+  }
+  CHECK_EQUAL(maintenance.remainingTime(Virtual64::now()), started + 90 * DAY_MS - Virtual64::now());
+  VirtualTimeSource::advance((unsigned long)maintenance.remainingTime(Virtual64::now()));
+  CHECK(maintenance.expired(Virtual64::now()));
+
+  // Fixed-point progress of an operation longer than three wraps
+  BasicAsyncOp<Virtual64> longOp;
+  uint64_t timeout = 3 * WRAP + 12345;
+  uint64_t opStart = Virtual64::now();
+  longOp.start(timeout, opStart);
+  uint32_t last = 0;
+  for (int quarter = 1; quarter < 4; quarter++) {
+    uint64_t target = opStart + timeout / 4 * quarter;
+    while (Virtual64::now() < target) {
+      uint64_t step = target - Virtual64::now();
+      VirtualTimeSource::advance((unsigned long)(step < 0x40000000ULL ? step : 0x40000000ULL));
+      Virtual64::now();
+      uint32_t progress = longOp.getProgressFixed(Virtual64::now());
+      CHECK(progress >= last);
+      last = progress;
+    }
+    uint32_t progress = longOp.getProgressFixed(Virtual64::now());
+    uint32_t exact = quarter * (PROGRESS_ONE / 4);
+    CHECK(progress + 2 >= exact && progress <= exact + 2);
+    CHECK_EQUAL(longOp.getProgress(Virtual64::now()), quarter * 25);
+  }
+  CHECK(longOp.getProgressFixed(opStart + timeout - 1) < PROGRESS_ONE);
+  CHECK_EQUAL(longOp.getProgressFixed(opStart + timeout), PROGRESS_ONE);
+  CHECK(!longOp.timedOut(opStart + timeout));
+  CHECK(longOp.timedOut(opStart + timeout + 1));
+  CHECK_EQUAL(longOp.getProgressFixed(opStart + timeout + 1), PROGRESS_ONE);
+
+  // 64-bit rollover: time_type arithmetic stays modular
+  BasicAsyncOp<Virtual64> op;
+  op.start(0x1000, MAX64 - 0x7FF);
+  CHECK_EQUAL(op.elapsedTime(0x7FE), 0xFFEULL);
+  CHECK_EQUAL(op.remainingTime(0x7FE), 2ULL);
+  CHECK_EQUAL(op.getProgressFixed(0x7FE), (uint32_t)((0xFFEULL << 16) / 0x1000));
+  CHECK(!op.timedOut(0x800));
+  CHECK(op.timedOut(0x801));
+
+  BasicTimer<Virtual64> timer(20);
+  timer.start(MAX64 - 9);
+  CHECK(!timer.expired(9));
+  CHECK_EQUAL(timer.remainingTime(9), 1ULL);
+  CHECK(timer.expired(10));
+
+  BasicButton<Virtual64> button(4);
+  hostSetPin(4, LOW);
+  CHECK(!button.update(MAX64 - 10));
+  CHECK(!button.update(39));  // 50 ms debounce not over yet
+  CHECK(button.update(40));
+  CHECK(button.isPressed());
+
+  TimerWheel<uint8_t, 4, Virtual64> wheel;
+  wheel.clear(MAX64 - 5);
+  wheel.schedule(10, 1, MAX64 - 5);    // Due at 4
+  wheel.schedule(40000, 2, MAX64 - 5); // Due at 39994, two levels up
+  CHECK_EQUAL(wheel.timeUntilDeadline(MAX64 - 5), 10ULL);
+  wheel.advance(3);
+  uint8_t fired;
+  CHECK(!wheel.pollExpired(fired));
+  CHECK_EQUAL(wheel.timeUntilDeadline(3), 1ULL);
+  wheel.advance(4);
+  CHECK(wheel.pollExpired(fired));
+  CHECK_EQUAL(fired, 1);
+  uint64_t deadline = 0;
+  CHECK(wheel.nextDeadline(deadline));
+  CHECK_EQUAL(deadline, 39994ULL);
+  wheel.advance(39994);
+  CHECK(wheel.pollExpired(fired));
+  CHECK_EQUAL(fired, 2);
+  CHECK_EQUAL(wheel.timeUntilDeadline(39994), MAX64);
+
+  return testResult();
+}
@@ -0,0 +1,63 @@
+/*
+ * Adaptive connect timeout after the network slows down
+ *
+ * Fast associations teach the sketch a short timeout. When association
+ * then takes longer than that, the timed-out attempts must count as
+ * samples so the timeout widens past the new association time, instead
+ * of only ever learning from the attempts that were fast enough.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <MooreArduino.h>
+#include "HostTest.h"
+#include "WiFiTypes.h"
+#include "WiFiCredentials.h"
+#include "WiFiMetrics.h"
+
+using namespace MooreArduino;
+
+void setup();
+void loop();
+
+extern MooreMachine<AppState, Input, Output> g_machine;  // Defined in the sketch
+
+const unsigned long MINUTE_MS = 60000UL;
+
+static void runFor(unsigned long ms) {
+  unsigned long until = VirtualTimeSource::now() + ms;
+  while (VirtualTimeSource::now() < until) {
+    loop();
+  }
+}
+
+int main() {
+  uint8_t ap[6] = {0x02, 0, 0, 0, 0, 1};
+  WiFi.sim().addAccessPoint("office", ap, "secret", -50);
+  WiFi.sim().setRssiNoise(0);
+  WiFi.sim().setJitter(0);
+  WiFi.sim().setLatencies(2000, 1500, 500);
+  WiFi.sim().setMeanTimeBetweenDrops(10 * MINUTE_MS);
+
+  Credentials creds;
+  strcpy(creds.ssid, "office");
+  strcpy(creds.pass, "secret");
+  saveCredentials(&creds);
+
+  Serial.setOutput(nullptr);
+  setup();
+
+  // Learn from fast associations: the floor of 5 s
+  runFor(120 * MINUTE_MS);
+  CHECK_EQUAL(adaptiveConnectTimeout(), 5000UL);
+  unsigned long drops = WiFi.sim().getDrops();
+  CHECK(drops >= 5);
+
+  // Association now takes 9 s, longer than the learned timeout
+  WiFi.sim().setLatencies(2000, 9000, 500);
+  runFor(180 * MINUTE_MS);
+  CHECK(WiFi.sim().getDrops() >= drops + 5);
+  CHECK(adaptiveConnectTimeout() > 9000);
+
+  return testResult();
+}
@@ -0,0 +1,103 @@
+/*
+ * Cached lease: reused on reconnect, but not once it is old and not after
+ * the first probe with it fails
+ *
+ * DHCP takes 5 s here, so whether a reconnect reused the cached lease
+ * shows in its time to an address.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <MooreArduino.h>
+#include <mbed_error.h>
+#include "HostTest.h"
+#include "kvstore_global_api.h"
+#include "WiFiTypes.h"
+#include "WiFiCredentials.h"
+
+using namespace MooreArduino;
+
+void setup();
+void loop();
+
+extern MooreMachine<AppState, Input, Output> g_machine;  // Defined in the sketch
+
+const unsigned long MINUTE_MS = 60000UL;
+const unsigned long DHCP_MS = 5000;
+
+static bool online() {
+  const AppState& state = g_machine.getState();
+  return state.mode == MODE_CONNECTED && state.hasIP;
+}
+
+static void runUntil(unsigned long at) {
+  while (VirtualTimeSource::now() < at) {
+    loop();
+  }
+}
+
+/*
+ * Take the access point away until the link drops, then bring it back
+ * @return Scan start to IP address of the reconnect, 0 if it never came back
+ */
+static unsigned long reconnect() {
+  unsigned long giveUp = VirtualTimeSource::now() + 5 * MINUTE_MS;
+  WiFi.sim().setAccessPointUp(0, false);
+  while (online() && VirtualTimeSource::now() < giveUp) {
+    loop();
+  }
+  WiFi.sim().setAccessPointUp(0, true);
+  while (!online() && VirtualTimeSource::now() < giveUp) {
+    loop();
+  }
+  const AppState& state = g_machine.getState();
+  return online() ? state.lastUpdate - state.attemptStartedAt : 0;
+}
+
+static bool leaseStored() {
+  uint8_t buffer[128];
+  size_t size = 0;
+  return kv_get("wifi_lease", buffer, sizeof(buffer), &size) == MBED_SUCCESS;
+}
+
+int main() {
+  uint8_t ap[6] = {0x02, 0, 0, 0, 0, 1};
+  WiFi.sim().addAccessPoint("office", ap, "secret", -50);
+  WiFi.sim().setLatencies(2000, 1500, DHCP_MS);
+  WiFi.sim().setJitter(0);
+  WiFi.sim().setRssiNoise(0);
+
+  Credentials creds;
+  strcpy(creds.ssid, "office");
+  strcpy(creds.pass, "secret");
+  saveCredentials(&creds);
+
+  Serial.setOutput(nullptr);
+  setup();
+
+  // First connection over DHCP caches the lease
+  runUntil(2 * MINUTE_MS);
+  CHECK(online());
+  CHECK(leaseStored());
+
+  // A young lease is reused, and the first probe with it succeeds
+  unsigned long reused = reconnect();
+  CHECK(reused > 0 && reused < DHCP_MS);
+  runUntil(VirtualTimeSource::now() + MINUTE_MS);
+  CHECK(leaseStored());
+
+  // Past the maximum age: DHCP again, which caches a fresh lease
+  runUntil(35 * MINUTE_MS);
+  unsigned long aged = reconnect();
+  CHECK(aged >= DHCP_MS);
+  CHECK(leaseStored());
+
+  // Young lease, but nothing gets through with it: dropped after the first probe
+  WiFi.sim().setUpstream(false);
+  unsigned long conflicted = reconnect();
+  CHECK(conflicted > 0 && conflicted < DHCP_MS);
+  runUntil(VirtualTimeSource::now() + 5000);
+  CHECK(!leaseStored());
+
+  return testResult();
+}
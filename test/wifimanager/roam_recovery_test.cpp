@@ -0,0 +1,71 @@
+/*
+ * Weak link with nothing better around, then the signal comes back
+ *
+ * Roam scans find no stronger access point (ROAM_SKIPPED), so the link
+ * stays up and stays degraded, also while the signal sits between the
+ * degraded and recovered thresholds. When the signal recovers, the link
+ * monitor has to report it - which it can only do if the roam scans did
+ * not make it forget that the link was degraded - and the scans must stop.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <MooreArduino.h>
+#include "HostTest.h"
+#include "WiFiTypes.h"
+#include "WiFiCredentials.h"
+
+using namespace MooreArduino;
+
+void setup();
+void loop();
+
+extern MooreMachine<AppState, Input, Output> g_machine;  // Defined in the sketch
+
+const unsigned long MINUTE_MS = 60000UL;
+
+static void runUntil(unsigned long at) {
+  while (VirtualTimeSource::now() < at) {
+    loop();
+  }
+}
+
+int main() {
+  uint8_t ap[6] = {0x02, 0, 0, 0, 0, 1};
+  WiFi.sim().addAccessPoint("office", ap, "secret", -50);
+  // Weak, then inside the hysteresis band (-75..-68 dBm) for a while, then good
+  WiFiSimRssiPoint fade[] = {
+    {5 * MINUTE_MS, -50}, {6 * MINUTE_MS, -80}, {10 * MINUTE_MS, -80},
+    {11 * MINUTE_MS, -72}, {20 * MINUTE_MS, -72}, {22 * MINUTE_MS, -50}
+  };
+  WiFi.sim().setRssiCurve(0, fade, 6);
+  WiFi.sim().setRssiNoise(0);
+
+  Credentials creds;
+  strcpy(creds.ssid, "office");
+  strcpy(creds.pass, "secret");
+  saveCredentials(&creds);
+
+  Serial.setOutput(nullptr);
+  setup();
+  const AppState& state = g_machine.getState();
+
+  // Weak for a while: degraded, roam scans skipped, still on the same link
+  runUntil(18 * MINUTE_MS);
+  CHECK_EQUAL(state.mode, MODE_CONNECTED);
+  CHECK(state.linkDegraded);
+  CHECK(state.roamCheckedAt > 6 * MINUTE_MS);
+  unsigned long associations = WiFi.sim().getAssociations();
+
+  // Signal back: recovered, and no roam scans after that
+  runUntil(25 * MINUTE_MS);
+  CHECK(!state.linkDegraded);
+  unsigned long lastRoamCheck = state.roamCheckedAt;
+  CHECK(lastRoamCheck < 23 * MINUTE_MS);
+  runUntil(40 * MINUTE_MS);
+  CHECK_EQUAL(state.roamCheckedAt, lastRoamCheck);
+  CHECK_EQUAL(state.mode, MODE_CONNECTED);
+  CHECK_EQUAL(WiFi.sim().getAssociations(), associations);
+
+  return testResult();
+}
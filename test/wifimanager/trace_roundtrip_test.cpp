@@ -0,0 +1,92 @@
+/*
+ * Record → encode → print → load → decode → replay round trip
+ *
+ * Runs the sketch through a busy simulated half day (roaming, drops, an
+ * upstream outage), prints the input trace exactly as the 't' command
+ * does, loads those lines back and replays them through a fresh machine.
+ * The replica has to end in the live machine's state.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <MooreArduino.h>
+#include "HostTest.h"
+#include "WiFiTypes.h"
+#include "WiFiCredentials.h"
+#include "WiFiStateMachine.h"
+#include "WiFiTrace.h"
+#include "WiFiReplay.h"
+
+using namespace MooreArduino;
+
+void setup();
+void loop();
+
+extern MooreMachine<AppState, Input, Output> g_machine;  // Defined in the sketch
+
+const unsigned long HOUR_MS = 3600000UL;
+
+int main() {
+  uint8_t ap1[6] = {0x02, 0, 0, 0, 0, 1};
+  uint8_t ap2[6] = {0x02, 0, 0, 0, 0, 2};
+  WiFi.sim().addAccessPoint("office", ap1, "secret", -50);
+  WiFi.sim().addAccessPoint("office", ap2, "secret", -62);
+  WiFiSimRssiPoint walk[] = { {0, -50}, {HOUR_MS, -84}, {2 * HOUR_MS, -50} };
+  WiFi.sim().setRssiCurve(0, walk, 3);
+  WiFi.sim().setMeanTimeBetweenDrops(HOUR_MS);
+
+  Credentials creds;
+  strcpy(creds.ssid, "office");
+  strcpy(creds.pass, "secret");
+  saveCredentials(&creds);
+
+  Serial.setOutput(nullptr);
+  setup();
+  while (VirtualTimeSource::now() < 12 * HOUR_MS) {
+    unsigned long now = VirtualTimeSource::now();
+    WiFi.sim().setUpstream(!(now >= 5 * HOUR_MS && now < 5 * HOUR_MS + 600000UL));
+    loop();
+  }
+  AppState live = g_machine.getState();
+  Output liveEffect = g_machine.getCurrentOutput();
+
+  // Print the trace as the board would, then load it from the "log"
+  FILE* log = tmpfile();
+  Serial.setOutput(log);
+  printTrace();
+  Serial.setOutput(nullptr);
+  clearTrace();
+  rewind(log);
+
+  AppState replayed;
+  FILE* steps = tmpfile();
+  unsigned long count = replayTrace(log, steps, &replayed);
+  fclose(steps);
+  fclose(log);
+
+  CHECK(count > 20);
+  CHECK(WiFi.sim().getDrops() > 0);
+  CHECK_EQUAL(replayed.mode, live.mode);
+  CHECK_EQUAL(replayed.wifiStatus, live.wifiStatus);
+  CHECK_EQUAL(replayed.lastUpdate, live.lastUpdate);
+  CHECK_EQUAL(replayed.attemptStartedAt, live.attemptStartedAt);
+  CHECK_EQUAL(replayed.connectStartedAt, live.connectStartedAt);
+  CHECK_EQUAL(replayed.associatedAt, live.associatedAt);
+  CHECK_EQUAL(replayed.hasIP, live.hasIP);
+  CHECK_EQUAL(replayed.linkDegraded, live.linkDegraded);
+  CHECK_EQUAL(replayed.rssi, live.rssi);
+  CHECK_EQUAL(replayed.roamCheckedAt, live.roamCheckedAt);
+  CHECK_EQUAL(replayed.upstreamLost, live.upstreamLost);
+  CHECK_EQUAL(replayed.connectTimeout, live.connectTimeout);
+  CHECK_EQUAL(replayed.credentialsChanged, live.credentialsChanged);
+  CHECK_EQUAL(replayed.shouldReconnect, live.shouldReconnect);
+  CHECK(strcmp(replayed.credentials.ssid, live.credentials.ssid) == 0);
+  CHECK_EQUAL(replayed.credentials.pass[0], '\0');  // Never recorded
+
+  // Same state, so λ agrees too
+  MooreMachine<AppState, Input, Output> replica(transitionFunction, replayed);
+  replica.setOutputFunction(outputFunction);
+  CHECK_EQUAL(replica.getCurrentOutput().type, liveEffect.type);
+
+  return testResult();
+}
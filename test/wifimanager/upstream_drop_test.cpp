@@ -0,0 +1,101 @@
+/*
+ * Upstream outage: probe → UPSTREAM_LOST → dropLink() → reconnect
+ *
+ * The access point stays up but nothing gets through to the probe host.
+ * The machine has to drop the link exactly once, reassociate, keep
+ * probing without dropping again, and clear upstreamLost when the probe
+ * host answers again. A probe may block the loop, but never for longer
+ * than its connect timeout - except for the one DNS lookup per outage
+ * that checks whether the probe host moved, which blocks until the
+ * resolver gives up.
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <MooreArduino.h>
+#include "HostTest.h"
+#include "WiFiTypes.h"
+#include "WiFiCredentials.h"
+
+using namespace MooreArduino;
+
+void setup();
+void loop();
+
+extern MooreMachine<AppState, Input, Output> g_machine;  // Defined in the sketch
+
+const unsigned long MINUTE_MS = 60000UL;
+const unsigned long DNS_TIMEOUT_MS = 10000;
+const unsigned long PROBE_BLOCK_MS = 1100;  // Probe connect timeout plus slack
+
+/*
+ * Loop iterations that blocked while connected the whole time
+ */
+struct Blocking {
+  unsigned long longest;
+  unsigned long overProbe;  // Longer than a probe connect may take
+};
+
+/*
+ * Run the sketch for `ms` of virtual time
+ */
+static Blocking runFor(unsigned long ms) {
+  unsigned long until = VirtualTimeSource::now() + ms;
+  Blocking blocking = {0, 0};
+  while (VirtualTimeSource::now() < until) {
+    bool wasConnected = g_machine.getState().mode == MODE_CONNECTED;
+    unsigned long before = VirtualTimeSource::now();
+    loop();
+    unsigned long took = VirtualTimeSource::now() - before;
+    if (wasConnected && g_machine.getState().mode == MODE_CONNECTED) {
+      if (took > blocking.longest) blocking.longest = took;
+      if (took > PROBE_BLOCK_MS) blocking.overProbe++;
+    }
+  }
+  return blocking;
+}
+
+int main() {
+  uint8_t ap[6] = {0x02, 0, 0, 0, 0, 1};
+  WiFi.sim().addAccessPoint("office", ap, "secret", -50);
+  WiFi.sim().setRssiNoise(0);
+  WiFi.sim().setDns(30, DNS_TIMEOUT_MS);
+
+  Credentials creds;
+  strcpy(creds.ssid, "office");
+  strcpy(creds.pass, "secret");
+  saveCredentials(&creds);
+
+  Serial.setOutput(nullptr);
+  setup();
+  Blocking healthy = runFor(5 * MINUTE_MS);
+  const AppState& state = g_machine.getState();
+  CHECK_EQUAL(state.mode, MODE_CONNECTED);
+  CHECK(state.hasIP);
+  CHECK(!state.upstreamLost);
+  CHECK(healthy.longest < 100);
+  CHECK_EQUAL(WiFi.sim().getLookups(), 1UL);  // Resolved once, then probed by address
+  unsigned long associations = WiFi.sim().getAssociations();
+
+  // Outage: three failed probes, then one drop and a fresh association
+  WiFi.sim().setUpstream(false);
+  Blocking outage = runFor(10 * MINUTE_MS);
+  CHECK(state.upstreamLost);
+  CHECK_EQUAL(state.mode, MODE_CONNECTED);
+  CHECK(state.hasIP);
+  CHECK_EQUAL(WiFi.sim().getAssociations(), associations + 1);
+  CHECK_EQUAL(WiFi.sim().getLookups(), 2UL);  // One refresh after the reconnect
+  CHECK_EQUAL(outage.overProbe, 1UL);         // That lookup is the only long block
+  CHECK(outage.longest <= DNS_TIMEOUT_MS + 50);
+
+  // Upstream back: the next probe clears the flag, no further reconnects
+  WiFi.sim().setUpstream(true);
+  Blocking recovery = runFor(5 * MINUTE_MS);
+  CHECK(!state.upstreamLost);
+  CHECK_EQUAL(state.mode, MODE_CONNECTED);
+  CHECK_EQUAL(WiFi.sim().getAssociations(), associations + 1);
+  CHECK_EQUAL(WiFi.sim().getLookups(), 2UL);
+  CHECK_EQUAL(recovery.overProbe, 0UL);
+
+  return testResult();
+}